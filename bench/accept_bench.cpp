@@ -0,0 +1,82 @@
+// Connection-storm load for server.cpp: every iteration connects, sends one
+// REGISTRATION_REQUEST, waits for the ack and closes, i.e. one accept per
+// request. Reports completed accepts per second.
+//
+//   g++ -std=c++14 -O2 -I.. accept_bench.cpp ../message.pb.cc -o accept_bench -lprotobuf -pthread
+//   ./accept_bench -h 127.0.0.1 -p 8082 -c 64 -s 10
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <string>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include "message.pb.h"
+
+std::atomic<bool> running(true);
+std::atomic<long> completed(0);
+std::atomic<long> failed(0);
+
+void storm(const sockaddr_in& server_address, int first_id) {
+    int id = first_id;
+    char buffer[1024];
+    while (running.load(std::memory_order_relaxed)) {
+        ClientMessage request;
+        request.set_type(REGISTRATION_REQUEST);
+        request.mutable_reg_req()->set_id(id++);
+        std::string serialized_msg;
+        request.SerializeToString(&serialized_msg);
+
+        int sock = socket(AF_INET, SOCK_STREAM, 0);
+        if (sock < 0 || connect(sock, (const sockaddr*)&server_address, sizeof(server_address)) < 0 ||
+            send(sock, serialized_msg.data(), serialized_msg.size(), MSG_NOSIGNAL) < 0 ||
+            recv(sock, buffer, sizeof(buffer), 0) <= 0) {
+            failed.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            completed.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (sock >= 0) close(sock);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string server_ip = "127.0.0.1";
+    int port = 8081, concurrency = 32, seconds = 10;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "h:p:c:s:")) != -1) {
+        switch (opt) {
+            case 'h': server_ip = optarg; break;
+            case 'p': port = std::stoi(optarg); break;
+            case 'c': concurrency = std::stoi(optarg); break;
+            case 's': seconds = std::stoi(optarg); break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [-h server_ip] [-p port] [-c clients] [-s seconds]\n";
+                return EXIT_FAILURE;
+        }
+    }
+
+    sockaddr_in server_address{};
+    server_address.sin_family = AF_INET;
+    server_address.sin_port = htons(port);
+    if (inet_pton(AF_INET, server_ip.c_str(), &server_address.sin_addr) <= 0) {
+        std::cerr << "Invalid address\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::thread> clients;
+    for (int i = 0; i < concurrency; ++i) {
+        clients.emplace_back(storm, server_address, i * 10000000);
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    running = false;
+    for (auto& t : clients) t.join();
+
+    std::cout << "accepts/sec: " << completed.load() / seconds
+              << "  (completed " << completed.load() << ", failed " << failed.load() << ")\n";
+    return 0;
+}
@@ -0,0 +1,23 @@
+#!/bin/sh
+# Accepts/sec of server.cpp as the number of SO_REUSEPORT acceptors grows.
+# Run from the bench/ directory after building ../server and ./accept_bench.
+#
+#   ./accept_scaling.sh [max_threads] [seconds]
+set -e
+
+MAX_THREADS=${1:-$(nproc)}
+SECONDS_PER_RUN=${2:-10}
+PORT=${PORT:-9090}
+CLIENTS=${CLIENTS:-64}
+
+threads=1
+while [ "$threads" -le "$MAX_THREADS" ]; do
+    ../server -p "$PORT" --io-threads "$threads" --reuseport --pin-cpus --backlog 4096 >/dev/null &
+    SERVER_PID=$!
+    sleep 1
+    printf "%3d acceptor(s): " "$threads"
+    ./accept_bench -p "$PORT" -c "$CLIENTS" -s "$SECONDS_PER_RUN"
+    kill "$SERVER_PID"
+    wait "$SERVER_PID" 2>/dev/null || true
+    threads=$((threads * 2))
+done
@@ -0,0 +1,27 @@
+#!/bin/sh
+# Requests/sec of server.cpp with request logging enabled vs disabled. Every
+# request is a new registration, so at "info" each one logs a line. The log
+# goes to a file, as in a real deployment, rather than to /dev/null.
+# Run from the bench/ directory after building ../server and ./accept_bench.
+#
+#   ./log_overhead.sh [seconds]
+set -e
+
+SECONDS_PER_RUN=${1:-10}
+PORT=${PORT:-9091}
+CLIENTS=${CLIENTS:-64}
+THREADS=${THREADS:-$(nproc)}
+LOG_FILE=${LOG_FILE:-/tmp/log_overhead.log}
+
+for level in off info; do
+    ../server -p "$PORT" --io-threads "$THREADS" --backlog 4096 --log-level "$level" >"$LOG_FILE" &
+    SERVER_PID=$!
+    sleep 1
+    printf "log level %-4s: " "$level"
+    ./accept_bench -p "$PORT" -c "$CLIENTS" -s "$SECONDS_PER_RUN"
+    kill "$SERVER_PID"
+    wait "$SERVER_PID" 2>/dev/null || true
+    echo "                ($(grep -c "User Registered" "$LOG_FILE" || true) requests logged)"
+    PORT=$((PORT + 1))  # The previous port may still have connections in TIME_WAIT
+done
+rm -f "$LOG_FILE"
@@ -0,0 +1,118 @@
+// Requests/sec of the REST client against serverAPI, one /register request
+// per ID:
+//  - per-call: a new curl handle and header list per request, as clientAPI
+//              used to do (new TCP connection every time)
+//  - reused:   RestClient::send(), one handle kept for the whole run
+//              (one keep-alive connection)
+//  - multi:    RestClient::sendBatch(), curl multi with 'concurrency'
+//              transfers over a pool of keep-alive connections
+//  - bulk:     RestClient::send() of /register/batch ranges of 'batch-size'
+//              IDs, counted per ID
+// Each mode registers its own ID range, so every request gets the same work.
+//
+//   g++ -std=c++17 -O2 -I.. rest_client_bench.cpp -o rest_client_bench -lcurl
+//   ./rest_client_bench [url] [requests] [concurrency] [batch-size]
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <curl/curl.h>
+#include "rest_client.h"
+
+static size_t discard(void*, size_t size, size_t nmemb, void*) { return size * nmemb; }
+
+// The old clientAPI sendPostRequest(): everything is rebuilt per call
+bool perCallPost(const std::string& url, const std::string& body) {
+    CURL* curl = curl_easy_init();
+    if (!curl) return false;
+    struct curl_slist* headers = curl_slist_append(nullptr, "Content-Type: application/json");
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_POST, 1L);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discard);
+    long code = 0;
+    if (curl_easy_perform(curl) == CURLE_OK) curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+    curl_easy_cleanup(curl);
+    curl_slist_free_all(headers);
+    return code == 200;
+}
+
+std::string registerBody(int id) {
+    return "{\"id\":" + std::to_string(id) + "}";
+}
+
+// Function to read "succeeded" from a batch reply (rest_json.h), 0 if missing
+int batchSucceeded(const std::string& reply) {
+    static const std::string key = "\"succeeded\":";
+    size_t at = reply.find(key);
+    return at == std::string::npos ? 0 : std::atoi(reply.c_str() + at + key.size());
+}
+
+void report(const char* mode, int requests, int failed, double seconds) {
+    std::cout << std::left << std::setw(10) << mode << std::right
+              << std::setw(10) << requests << " requests"
+              << std::setw(8) << failed << " failed"
+              << std::setw(12) << std::fixed << std::setprecision(0) << requests / seconds << " req/s" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string url = argc > 1 ? argv[1] : "http://127.0.0.1:8081";
+    int requests = argc > 2 ? std::stoi(argv[2]) : 5000;
+    int concurrency = argc > 3 ? std::stoi(argv[3]) : 16;
+    int batchSize = argc > 4 ? std::max(1, std::stoi(argv[4])) : 1000;
+
+    curl_global_init(CURL_GLOBAL_ALL);
+    RestClient client(url);
+    using Clock = std::chrono::steady_clock;
+
+    int failed = 0;
+    auto start = Clock::now();
+    for (int i = 0; i < requests; ++i) {
+        if (!perCallPost(url + "/register", registerBody(i))) ++failed;
+    }
+    report("per-call", requests, failed, std::chrono::duration<double>(Clock::now() - start).count());
+
+    failed = 0;
+    start = Clock::now();
+    for (int i = 0; i < requests; ++i) {
+        RestRequest request;
+        request.path = "/register";
+        request.body = registerBody(requests + i);
+        if (client.send(request).code != 200) ++failed;
+    }
+    report("reused", requests, failed, std::chrono::duration<double>(Clock::now() - start).count());
+
+    std::vector<RestRequest> batch(requests);
+    for (int i = 0; i < requests; ++i) {
+        batch[i].path = "/register";
+        batch[i].body = registerBody(2 * requests + i);
+    }
+    failed = 0;
+    start = Clock::now();
+    client.sendBatch(batch, concurrency, [&](size_t, RestResponse& response) {
+        if (response.code != 200) ++failed;
+    });
+    std::string mode = "multi x" + std::to_string(concurrency);
+    report(mode.c_str(), requests, failed, std::chrono::duration<double>(Clock::now() - start).count());
+
+    failed = 0;
+    start = Clock::now();
+    for (int first = 0; first < requests; first += batchSize) {
+        int last = std::min(requests, first + batchSize) - 1;
+        RestRequest request;
+        request.path = "/register/batch";
+        request.body = "{\"from\":" + std::to_string(3 * requests + first) +
+                       ",\"to\":" + std::to_string(3 * requests + last) + "}";
+        RestResponse response = client.send(request);
+        failed += last - first + 1 - (response.code == 200 ? batchSucceeded(response.body) : 0);
+    }
+    mode = "bulk x" + std::to_string(batchSize);
+    report(mode.c_str(), requests, failed, std::chrono::duration<double>(Clock::now() - start).count());
+
+    curl_global_cleanup();
+    return 0;
+}
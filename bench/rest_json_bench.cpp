@@ -0,0 +1,75 @@
+// Time per request body of serverAPI's JSON handling, for the /register and
+// /pdu-session bodies the clients send:
+//  - nlohmann: json::parse() + at() to read, a json object + dump() to reply,
+//              as the handlers used to do
+//  - scan:     scanRequest() in place + a preformatted reply (rest_json.h)
+//
+//   g++ -std=c++17 -O2 -I.. rest_json_bench.cpp -o rest_json_bench
+//   ./rest_json_bench [iterations]
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <nlohmann/json.hpp>
+#include "rest_json.h"
+
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+void report(const char* mode, const char* body, long iterations, double seconds, size_t checksum) {
+    std::cout << std::left << std::setw(10) << mode << std::setw(12) << body << std::right
+              << std::setw(10) << std::fixed << std::setprecision(1) << seconds * 1e9 / iterations << " ns/request"
+              << "   (checksum " << checksum << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    long iterations = argc > 1 ? std::stol(argv[1]) : 1000000;
+    const std::string registerBody = R"({"id":123456})";
+    const std::string pduBody = R"({"id":123456,"sst":1,"sd":"0101"})";
+    size_t checksum = 0;   // Keeps the compiler from dropping the work
+
+    auto start = Clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        auto body = json::parse(registerBody);
+        int id = body.at("id");
+        json reply;
+        reply["status"] = 200;
+        reply["message"] = "Registration Successful";
+        checksum += static_cast<size_t>(id) + reply.dump().size();
+    }
+    report("nlohmann", "register", iterations, std::chrono::duration<double>(Clock::now() - start).count(), checksum);
+
+    checksum = 0;
+    start = Clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        RestFields fields;
+        scanRequest(registerBody, fields);
+        checksum += static_cast<size_t>(fields.id) + restReply(REG_SUCCESSFUL).size();
+    }
+    report("scan", "register", iterations, std::chrono::duration<double>(Clock::now() - start).count(), checksum);
+
+    checksum = 0;
+    start = Clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        auto body = json::parse(pduBody);
+        int id = body.at("id");
+        int sst = body.at("sst");
+        std::string sd = body.at("sd");
+        json reply;
+        reply["status"] = 200;
+        reply["pdu_id"] = 1;
+        reply["message"] = "PDU Session Established";
+        checksum += static_cast<size_t>(id + sst) + sd.size() + reply.dump().size();
+    }
+    report("nlohmann", "pdu-session", iterations, std::chrono::duration<double>(Clock::now() - start).count(), checksum);
+
+    checksum = 0;
+    start = Clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        RestFields fields;
+        scanRequest(pduBody, fields);
+        checksum += static_cast<size_t>(fields.id + fields.sst) + fields.sd.size() + restPduEstablished(1).size();
+    }
+    report("scan", "pdu-session", iterations, std::chrono::duration<double>(Clock::now() - start).count(), checksum);
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Requests/sec of serverAPI with JSON bodies vs protobuf bodies on the same
+// endpoints. Each format runs the same workload on its own ID range:
+// 'requests' registrations, then one PDU session and one deregistration per
+// ID, with 'concurrency' requests in flight (RestClient::sendBatch()).
+//  - json:     {"id":N} bodies, JSON replies parsed with nlohmann::json
+//  - protobuf: ClientMessage bodies (Content-Type: application/x-protobuf),
+//              ServerMessage replies (Accept: application/x-protobuf)
+// Every reply is decoded, so the client's side of each format is counted.
+//
+//   g++ -std=c++17 -O2 -I.. rest_proto_bench.cpp ../message.pb.cc -o rest_proto_bench -lcurl -lprotobuf
+//   ./rest_proto_bench [url] [requests] [concurrency]
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+#include "rest_client.h"
+#include "message.pb.h"
+
+using json = nlohmann::json;
+
+struct Phase {
+    const char* path;
+    bool isDelete;
+    MessageType type;
+};
+
+static const Phase phases[] = {
+    {"/register",    false, REGISTRATION_REQUEST},
+    {"/pdu-session", false, PDU_SESSION_REQUEST},
+    {"/deregister",  true,  DEREGISTRATION_REQUEST},
+};
+
+RestRequest makeRequest(const Phase& phase, int id, bool protobuf) {
+    RestRequest request;
+    request.path = phase.path;
+    request.isDelete = phase.isDelete;
+    request.protobuf = protobuf;
+    if (!protobuf) {
+        request.body = phase.type == PDU_SESSION_REQUEST
+                           ? R"({"id":)" + std::to_string(id) + R"(,"sst":1,"sd":"0101"})"
+                           : R"({"id":)" + std::to_string(id) + "}";
+        return request;
+    }
+    ClientMessage message;
+    message.set_type(phase.type);
+    message.set_request_id(static_cast<uint64_t>(id));
+    if (phase.type == REGISTRATION_REQUEST) {
+        message.mutable_reg_req()->set_id(id);
+    } else if (phase.type == PDU_SESSION_REQUEST) {
+        message.mutable_pdu_req()->set_id(id);
+        message.mutable_pdu_req()->set_sst(1);
+        message.mutable_pdu_req()->set_sd("0101");
+    } else {
+        message.mutable_dereg_req()->set_id(id);
+    }
+    message.SerializeToString(&request.body);
+    return request;
+}
+
+// Function to decode a reply and return its status, 0 if it could not be decoded
+int replyStatus(const RestResponse& response, bool protobuf) {
+    if (response.code != 200) return 0;
+    if (!protobuf) {
+        json reply = json::parse(response.body, nullptr, false);
+        return reply.is_object() && reply.contains("status") ? reply["status"].get<int>() : 0;
+    }
+    ServerMessage reply;
+    if (!reply.ParseFromString(response.body)) return 0;
+    switch (reply.payload_case()) {
+        case ServerMessage::kRegAck: return reply.reg_ack().status();
+        case ServerMessage::kPduAck: return reply.pdu_ack().status();
+        case ServerMessage::kDeregAck: return reply.dereg_ack().status();
+        default: return 0;
+    }
+}
+
+void run(RestClient& client, bool protobuf, int firstId, int requests, size_t concurrency) {
+    size_t total = 0, ok = 0, failed = 0, requestBytes = 0, replyBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const Phase& phase : phases) {
+        std::vector<RestRequest> batch;
+        batch.reserve(requests);
+        for (int i = 0; i < requests; ++i) {
+            batch.push_back(makeRequest(phase, firstId + i, protobuf));
+            requestBytes += batch.back().body.size();
+        }
+        client.sendBatch(batch, concurrency, [&](size_t, RestResponse& response) {
+            ++total;
+            replyBytes += response.body.size();
+            int status = replyStatus(response, protobuf);
+            if (status == 200) {
+                ++ok;
+            } else if (status == 0) {
+                ++failed;
+            }
+        });
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::left << std::setw(10) << (protobuf ? "protobuf" : "json") << std::right
+              << std::setw(10) << total << " requests" << std::setw(8) << ok << " ok" << std::setw(8) << failed << " failed"
+              << std::setw(12) << std::fixed << std::setprecision(0) << total / seconds << " req/s"
+              << std::setw(8) << std::setprecision(1) << static_cast<double>(requestBytes) / total << " B/request"
+              << std::setw(8) << static_cast<double>(replyBytes) / total << " B/reply" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    GOOGLE_PROTOBUF_VERIFY_VERSION;
+    std::string url = argc > 1 ? argv[1] : "http://127.0.0.1:8081";
+    int requests = argc > 2 ? std::stoi(argv[2]) : 20000;
+    size_t concurrency = argc > 3 ? std::stoul(argv[3]) : 16;
+
+    curl_global_init(CURL_GLOBAL_ALL);
+    {
+        RestClient client(url);
+        run(client, false, 1, requests, concurrency);
+        run(client, true, requests + 1, requests, concurrency);
+    }
+    curl_global_cleanup();
+    google::protobuf::ShutdownProtobufLibrary();
+    return 0;
+}
@@ -0,0 +1,41 @@
+#!/bin/sh
+# Requests/sec of serverAPI.cpp as the number of Pistache workers grows, each
+# pinned to its own CPU. A single clientAPI is one curl multi loop on one
+# core, so CLIENTS of them run side by side (on disjoint ID ranges) and their
+# rates are summed; raise CLIENTS until the top step stops growing with it.
+# Run from the bench/ directory after building ../serverAPI and ../clientAPI.
+#
+#   ./rest_scaling.sh [max_workers] [requests_per_client]
+set -e
+
+MAX_WORKERS=${1:-$(nproc)}
+REQUESTS=${2:-50000}
+PORT=${PORT:-9190}
+CLIENTS=${CLIENTS:-4}
+CONCURRENCY=${CONCURRENCY:-32}
+OUT=${OUT:-/tmp/rest_scaling}
+
+workers=1
+while [ "$workers" -le "$MAX_WORKERS" ]; do
+    ../serverAPI -p "$PORT" --workers "$workers" --pin-cpus --log-level off >/dev/null &
+    SERVER_PID=$!
+    sleep 1
+    CLIENT_PIDS=""
+    client=0
+    while [ "$client" -lt "$CLIENTS" ]; do
+        ../clientAPI --url "http://127.0.0.1:$PORT" --bench --requests "$REQUESTS" \
+            --concurrency "$CONCURRENCY" --first-id $((client * REQUESTS + 1)) --ids "$REQUESTS" \
+            >"$OUT.$client" &
+        CLIENT_PIDS="$CLIENT_PIDS $!"
+        client=$((client + 1))
+    done
+    wait $CLIENT_PIDS || true
+    printf "%3d worker(s): " "$workers"
+    cat "$OUT".* | awk '/^Requests:/ { rate += $(NF - 1); errors += $4 }
+        END { printf "%10.0f req/s, %d errors\n", rate, errors }'
+    kill "$SERVER_PID"
+    wait "$SERVER_PID" 2>/dev/null || true
+    rm -f "$OUT".*
+    workers=$((workers * 2))
+    PORT=$((PORT + 1))  # The previous port may still have connections in TIME_WAIT
+done
@@ -0,0 +1,112 @@
+// Restart time of the subscriber core with N registered IDs (bitmap store)
+// and a PDU session for each ID below N/10: replaying the whole write-ahead
+// log versus mapping a snapshot (snapshot.h) and replaying the log after it.
+// Also reports the time to write the snapshot and to serve the first
+// requests from a mapped snapshot, which copy the pages they touch.
+//
+//   g++ -std=c++14 -O2 -I.. snapshot_restart.cpp -o snapshot_restart -pthread
+//   ./snapshot_restart [ids] [dir]
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "subscriber_core.h"
+
+#define BATCH_SIZE 65536
+#define FIRST_REQUESTS 100000
+
+using Clock = std::chrono::steady_clock;
+
+SubscriberCore subscriber_core;  // Unused; the benchmark makes its own cores
+
+double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void report(const char* step, double ms) {
+    std::cout << std::left << std::setw(36) << step << std::right << std::setw(10) << std::fixed
+              << std::setprecision(1) << ms << " ms" << std::endl;
+}
+
+// Function to copy a file; false if it cannot be read or written
+bool copy_file(const std::string& from, const std::string& to) {
+    FILE* in = fopen(from.c_str(), "rb");
+    FILE* out = fopen(to.c_str(), "wb");
+    bool ok = in != nullptr && out != nullptr;
+    char buffer[1 << 16];
+    size_t n;
+    while (ok && (n = fread(buffer, 1, sizeof(buffer), in)) > 0) ok = fwrite(buffer, 1, n, out) == n;
+    if (in != nullptr) fclose(in);
+    if (out != nullptr) ok = fclose(out) == 0 && ok;
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    int ids = argc > 1 ? std::stoi(argv[1]) : 10000000;
+    std::string dir = argc > 2 ? argv[2] : "/tmp";
+    std::string wal_path = dir + "/snapshot_restart.wal";
+    std::string full_wal_path = dir + "/snapshot_restart.full.wal";
+    std::string snapshot_path = dir + "/snapshot_restart.snap";
+    for (const std::string& path : {wal_path, wal_path + ".prev", full_wal_path, snapshot_path}) unlink(path.c_str());
+    log_level().store(LOG_LEVEL_WARN);
+
+    // Build the state through a logged core, as a server would
+    {
+        std::unique_ptr<SubscriberCore> core(new SubscriberCore());
+        if (!core->init("bitmap") || !core->open_wal(wal_path, WAL_DEFAULT_COMMIT_US)) return 1;
+        std::vector<int> batch;
+        std::vector<AckKind> kinds(BATCH_SIZE);
+        std::vector<int> pdu_ids(BATCH_SIZE);
+        auto start = Clock::now();
+        for (int first = 0; first < ids; first += BATCH_SIZE) {
+            batch.clear();
+            for (int id = first; id < std::min(ids, first + BATCH_SIZE); ++id) batch.push_back(id);
+            core->register_users(batch.data(), batch.size(), kinds.data());
+            if (first < ids / 10) core->pdu_sessions(batch.data(), batch.size(), 1, "0101", 4, kinds.data(), pdu_ids.data());
+        }
+        core->wal()->wait_durable(core->wal()->appended());
+        report("register + log", elapsed_ms(start));
+        if (!copy_file(wal_path, full_wal_path)) return 1;
+
+        start = Clock::now();
+        if (!core->write_snapshot(snapshot_path)) return 1;
+        report("write snapshot", elapsed_ms(start));
+    }
+
+    // Restart by replaying the whole log
+    {
+        std::unique_ptr<SubscriberCore> core(new SubscriberCore());
+        auto start = Clock::now();
+        if (!core->init("bitmap") || !core->open_wal(full_wal_path, WAL_DEFAULT_COMMIT_US)) return 1;
+        report("restart: replay whole log", elapsed_ms(start));
+    }
+
+    // Restart from the snapshot and the log after it
+    std::unique_ptr<SubscriberCore> core(new SubscriberCore());
+    auto start = Clock::now();
+    if (!core->init("bitmap") || !core->load_snapshot(snapshot_path) ||
+        !core->open_wal(wal_path, WAL_DEFAULT_COMMIT_US)) {
+        return 1;
+    }
+    report("restart: map snapshot + log tail", elapsed_ms(start));
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> any_id(0, ids - 1);
+    size_t successful = 0;
+    start = Clock::now();
+    for (int i = 0; i < FIRST_REQUESTS; ++i) {
+        int pdu_id;
+        AckKind kind = i % 2 ? core->register_user(any_id(rng))
+                             : core->pdu_session(any_id(rng), 1, "0101", 4, pdu_id);
+        successful += ack_definition(kind).status == 200;
+    }
+    report("first requests after restart", elapsed_ms(start));
+    std::cout << FIRST_REQUESTS << " requests, " << successful << " successful" << std::endl;
+
+    for (const std::string& path : {wal_path, wal_path + ".prev", full_wal_path, snapshot_path}) unlink(path.c_str());
+    return 0;
+}
@@ -0,0 +1,82 @@
+// Contention benchmark for the registration store: T threads run a
+// register/lookup/deregister mix over a shared ID range. Compares one global
+// mutex around std::unordered_map (the minimum needed to make the original
+// map thread-safe) with the sharded and bitmap RegistrationStore backends.
+//
+//   g++ -std=c++14 -O2 -I.. store_contention.cpp -o store_contention -pthread
+//   ./store_contention [max_threads] [ops_per_thread]
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "registration_store.h"
+
+#define ID_RANGE 1000000
+
+// Baseline: the original map behind a single lock
+class GlobalLockStore {
+public:
+    bool register_id(int id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return users_.emplace(id, true).second;
+    }
+    bool is_registered(int id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return users_.count(id) != 0;
+    }
+    bool deregister_id(int id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return users_.erase(id) != 0;
+    }
+private:
+    std::mutex mutex_;
+    std::unordered_map<int, bool> users_;
+};
+
+// 50% lookups, 25% registrations, 25% deregistrations
+template <typename Store>
+void worker(Store& store, int seed, long ops) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> ids(0, ID_RANGE - 1);
+    for (long i = 0; i < ops; ++i) {
+        int id = ids(rng);
+        switch (rng() & 3) {
+            case 0: store.register_id(id); break;
+            case 1: store.deregister_id(id); break;
+            default: store.is_registered(id); break;
+        }
+    }
+}
+
+template <typename Store>
+double run(int threads, long ops_per_thread) {
+    Store store;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&store, t, ops_per_thread] { worker(store, t + 1, ops_per_thread); });
+    }
+    for (auto& t : pool) t.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return threads * ops_per_thread / elapsed.count();
+}
+
+int main(int argc, char* argv[]) {
+    int max_threads = argc > 1 ? std::stoi(argv[1]) : std::max(1u, std::thread::hardware_concurrency());
+    long ops_per_thread = argc > 2 ? std::stol(argv[2]) : 2000000;
+
+    std::cout << std::setw(8) << "threads" << std::setw(20) << "global lock ops/s"
+              << std::setw(20) << "sharded ops/s" << std::setw(20) << "bitmap ops/s" << "\n";
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        double global = run<GlobalLockStore>(threads, ops_per_thread);
+        double sharded = run<ShardedRegistrationStore>(threads, ops_per_thread);
+        double bitmap = run<BitmapRegistrationStore>(threads, ops_per_thread);
+        std::cout << std::setw(8) << threads << std::setw(20) << std::fixed << std::setprecision(0) << global
+                  << std::setw(20) << sharded << std::setw(20) << bitmap << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,41 @@
+#!/bin/sh
+# Requests/sec and latency of the framed server.cpp without a write-ahead log
+# and with one at several group commit budgets (--wal-commit-us). Replies are
+# held until their WAL group is synced, so the latency columns include the
+# fdatasync. The log is written to WAL_DIR; use the disk you would deploy on.
+# Run from the bench/ directory after building ../server and ../client.
+#
+#   ./wal_group_commit.sh [seconds] [budgets in us...]
+set -e
+
+SECONDS_PER_RUN=${1:-10}
+[ $# -gt 0 ] && shift
+BUDGETS=${*:-0 200 1000}
+PORT=${PORT:-9191}
+THREADS=${THREADS:-$(nproc)}
+CONNECTIONS=${CONNECTIONS:-16}
+WINDOW=${WINDOW:-16}
+WAL_DIR=${WAL_DIR:-/tmp}
+
+run() {
+    label=$1
+    shift
+    ../server -p "$PORT" --io-threads "$THREADS" --framed --log-level warn "$@" >/dev/null &
+    SERVER_PID=$!
+    sleep 1
+    printf "%-12s " "$label"
+    ../client --bench -h 127.0.0.1 -p "$PORT" -f --threads "$THREADS" --connections "$CONNECTIONS" \
+        -w "$WINDOW" --duration "$SECONDS_PER_RUN" | grep -E "^Requests|^all" | tr '\n' ' '
+    echo
+    kill "$SERVER_PID"
+    wait "$SERVER_PID" 2>/dev/null || true
+    PORT=$((PORT + 1))
+}
+
+run "no wal"
+for budget in $BUDGETS; do
+    WAL_FILE="$WAL_DIR/wal_group_commit.$budget.wal"
+    rm -f "$WAL_FILE"
+    run "wal ${budget}us" --wal "$WAL_FILE" --wal-commit-us "$budget"
+    rm -f "$WAL_FILE"
+done
@@ -0,0 +1,49 @@
+// CRC-32 (IEEE 802.3, as in zlib) for the on-disk formats: write-ahead log
+// records (wal.h) and snapshot sections (snapshot.h).
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Function to compute the CRC-32 of a byte range, continuing from 'crc'
+// (0 to start), so a long range can be checksummed in pieces. Eight bytes
+// are folded per step (slicing-by-8), which keeps checking a whole snapshot
+// at load cheap.
+inline uint32_t crc32(const void* data, size_t len, uint32_t crc = 0) {
+    struct Table {
+        uint32_t entries[8][256];  // entries[k][b]: CRC of b followed by k zero bytes
+        Table() {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                entries[0][i] = c;
+            }
+            for (uint32_t i = 0; i < 256; ++i) {
+                for (int k = 1; k < 8; ++k) {
+                    entries[k][i] = entries[0][entries[k - 1][i] & 0xFF] ^ (entries[k - 1][i] >> 8);
+                }
+            }
+        }
+    };
+    static const Table table;
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (; len >= 8; p += 8, len -= 8) {
+        uint32_t low, high;
+        std::memcpy(&low, p, 4);
+        std::memcpy(&high, p + 4, 4);
+        low ^= crc;
+        crc = table.entries[7][low & 0xFF] ^ table.entries[6][(low >> 8) & 0xFF] ^
+              table.entries[5][(low >> 16) & 0xFF] ^ table.entries[4][low >> 24] ^
+              table.entries[3][high & 0xFF] ^ table.entries[2][(high >> 8) & 0xFF] ^
+              table.entries[1][(high >> 16) & 0xFF] ^ table.entries[0][high >> 24];
+    }
+#endif
+    for (size_t i = 0; i < len; ++i) crc = table.entries[0][(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+#endif // CHECKSUM_H
@@ -1,16 +1,47 @@
 #include <iostream>
 #include <cstring>
+#include <algorithm>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <getopt.h>
+#include <unordered_map>
+#include <deque>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <fcntl.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
 #include "message.pb.h"
+#include "framing.h"
+#include "metrics.h"
+#include "control_client.h"
 
 #define DEFAULT_PORT 8081
 #define DEFAULT_SERVER_IP "127.0.0.1"
+#define BENCH_EVENTS 256     // epoll events handled per wakeup in --bench mode
+#define BENCH_READ_CHUNK 16384
 
-// Function to handle sending the request
-void send_request(const std::string& server_ip, int port, ClientMessage& request) {
+// Load generator settings (--bench)
+struct BenchOptions {
+    bool enabled = false;
+    int threads = 1;              // Load threads
+    int connections = 1;          // Connections per thread
+    int mix[3] = {100, 0, 0};     // Weights of REGISTRATION / PDU_SESSION / DEREGISTRATION requests
+    int first_id = 1;             // IDs are drawn uniformly from [first_id, first_id + id_count)
+    int id_count = 1000;
+    int sst = 1;                  // S-NSSAI of PDU session requests
+    std::string sd = "0001";
+    double rate = 0;              // Total requests/sec (open loop); 0 = closed loop
+    int duration = 10;            // Seconds of load
+};
+
+// Function to open a TCP connection to the server
+int connect_to_server(const std::string& server_ip, int port) {
     int sock = socket(AF_INET, SOCK_STREAM, 0);
     if (sock < 0) {
         perror("Socket creation error");
@@ -32,38 +63,517 @@ void send_request(const std::string& server_ip, int port, ClientMessage& request
         close(sock);
         exit(EXIT_FAILURE);
     }
+    return sock;
+}
 
-    std::string serialized_msg;
-    request.SerializeToString(&serialized_msg);
-    send(sock, serialized_msg.c_str(), serialized_msg.size(), 0);
+// Function to print a decoded server reply
+void print_response(const ServerMessage& response) {
+    if (response.type() == BATCH_ACK) {
+        for (const ServerMessage& item : response.batch().messages()) {
+            print_response(item);
+        }
+    } else if (response.type() == REGISTRATION_ACK) {
+        std::cout << "Server Response: " << response.reg_ack().status_message() << std::endl;
+    } else if (response.type() == PDU_SESSION_ACK) {
+        std::cout << "PDU Allocated: " << response.pdu_ack().pdu_id() << " - " << response.pdu_ack().status_message() << std::endl;
+    } else if (response.type() == DEREGISTRATION_ACK) {
+        std::cout << "Server Response: " << response.dereg_ack().status_message() << std::endl;
+    }
+}
 
-    char buffer[1024] = {0};
-    recv(sock, buffer, sizeof(buffer), 0);
+// Function to set the subscriber ID of whichever request 'message' carries
+void set_subscriber_id(ClientMessage& message, int id) {
+    switch (message.type()) {
+        case REGISTRATION_REQUEST:   message.mutable_reg_req()->set_id(id); break;
+        case PDU_SESSION_REQUEST:    message.mutable_pdu_req()->set_id(id); break;
+        case DEREGISTRATION_REQUEST: message.mutable_dereg_req()->set_id(id); break;
+        default: break;
+    }
+}
 
-    ServerMessage response;
-    if (response.ParseFromString(std::string(buffer))) {
-        if (response.type() == REGISTRATION_ACK) {
-            std::cout << "Server Response: " << response.reg_ack().status_message() << std::endl;
-        } else if (response.type() == PDU_SESSION_ACK) {
-            std::cout << "PDU Allocated: " << response.pdu_ack().pdu_id() << " - " << response.pdu_ack().status_message() << std::endl;
-        } else if (response.type() == DEREGISTRATION_ACK) {
-            std::cout << "Server Response: " << response.dereg_ack().status_message() << std::endl;
-        }
+bool send_all(int sock, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(sock, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += n;
+    }
+    return true;
+}
+
+bool recv_exact(int sock, char* buffer, size_t len) {
+    size_t received = 0;
+    while (received < len) {
+        ssize_t n = recv(sock, buffer + received, len - received, 0);
+        if (n <= 0) return false;
+        received += n;
+    }
+    return true;
+}
+
+// Function to read one length-prefixed ServerMessage
+bool recv_frame(int sock, ServerMessage& response) {
+    char header[FRAME_HEADER_SIZE];
+    if (!recv_exact(sock, header, sizeof(header))) return false;
+    uint32_t len = get_frame_length(header);
+    if (len > MAX_FRAME_SIZE) return false;
+    std::string payload(len, '\0');
+    return recv_exact(sock, &payload[0], len) && response.ParseFromString(payload);
+}
+
+// Function to handle sending the request. Returns false if it got no reply.
+bool send_request(const std::string& server_ip, int port, ClientMessage& request) {
+    ControlClientOptions options;
+    options.host = server_ip;
+    options.port = port;
+    options.framed = false;
+    options.connections = 1;
+    ControlClient client(options);
+    std::string error;
+    if (!client.start(error)) {
+        std::cerr << error << std::endl;
+        return false;
+    }
+
+    ControlReply reply = client.send(request).get();
+    if (reply.failed()) {
+        std::cerr << reply.message << std::endl;
+        return false;
+    }
+    if (request.type() == PDU_SESSION_REQUEST) {
+        std::cout << "PDU Allocated: " << reply.pdu_id << " - " << reply.message << std::endl;
     } else {
-        std::cerr << "Failed to parse server response\n";
+        std::cout << "Server Response: " << reply.message << std::endl;
+    }
+    return true;
+}
+
+// Function to send 'count' requests (IDs id, id+1, ...) over one persistent,
+// framed connection, keeping up to 'window' frames in flight. With
+// batch_size > 1 each frame is a ClientBatch of up to batch_size requests.
+// Replies are matched to frames by request_id since they may arrive out of
+// order. Requires a server started with --framed.
+void send_framed_requests(const std::string& server_ip, int port, ClientMessage& request,
+                          int count, int window, int batch_size) {
+    int sock = connect_to_server(server_ip, port);
+    int first_id = request.has_reg_req() ? request.reg_req().id()
+                 : request.has_pdu_req() ? request.pdu_req().id()
+                 : request.dereg_req().id();
+
+    std::unordered_map<uint64_t, int> in_flight;  // request_id -> first subscriber ID in the frame
+    uint64_t next_request_id = 1;
+    int sent = 0;
+    while (sent < count || !in_flight.empty()) {
+        // Fill the pipeline with one write
+        std::string frames;
+        while (sent < count && static_cast<int>(in_flight.size()) < window) {
+            uint64_t request_id = next_request_id++;
+            in_flight[request_id] = first_id + sent;
+            if (batch_size > 1) {
+                ClientMessage batch;
+                batch.set_type(BATCH_REQUEST);
+                batch.set_request_id(request_id);
+                for (int i = 0; i < batch_size && sent < count; ++i, ++sent) {
+                    ClientMessage* item = batch.mutable_batch()->add_messages();
+                    *item = request;
+                    set_subscriber_id(*item, first_id + sent);
+                }
+                append_frame(batch, frames);
+            } else {
+                request.set_request_id(request_id);
+                set_subscriber_id(request, first_id + sent);
+                append_frame(request, frames);
+                ++sent;
+            }
+        }
+        if (!frames.empty() && !send_all(sock, frames)) {
+            std::cerr << "Failed to send framed requests to server\n";
+            break;
+        }
+
+        ServerMessage response;
+        if (!recv_frame(sock, response)) {
+            std::cerr << "Failed to receive framed response from server\n";
+            break;
+        }
+        if (in_flight.erase(response.request_id()) == 0) {
+            std::cerr << "Unexpected response with request_id " << response.request_id() << "\n";
+            continue;
+        }
+        print_response(response);
     }
 
     close(sock);
 }
 
+// Load generator (--bench). Every thread drives its own connections from an
+// epoll loop: persistent framed connections with up to 'window' requests in
+// flight each, or (legacy protocol) one connection per request.
+//
+// Closed loop: a connection sends its next request as soon as a slot frees
+// up, and latency is measured from the actual send.
+// Open loop: every connection is scheduled for a fixed share of --rate. A
+// request that cannot go out on time (window full) waits its turn, and its
+// latency is still measured from the time it was scheduled, so a stalled
+// server is not hidden by the generator slowing down (coordinated omission).
+
+// One request awaiting its reply
+struct BenchRequest {
+    uint64_t start_ns;   // Scheduled (open loop) or actual (closed loop) send time
+    int slot;            // Request type: 0 REGISTRATION, 1 PDU_SESSION, 2 DEREGISTRATION
+};
+
+struct BenchConnection {
+    int fd = -1;
+    std::string out;
+    size_t out_offset = 0;
+    std::string in;
+    std::unordered_map<uint64_t, BenchRequest> in_flight;  // request_id -> request
+    std::deque<uint64_t> overdue;  // Open loop: scheduled start times not yet sent
+    uint64_t next_due_ns = 0;      // Open loop: next scheduled start
+};
+
+// Results of one load thread, merged after the run
+struct BenchStats {
+    LatencyHistogram latency[3];        // Per request type
+    uint64_t completed = 0;
+    uint64_t errors = 0;                // Failed connections or undecodable replies
+    uint64_t unsent = 0;                // Open loop: still behind schedule at the end
+    std::map<int, uint64_t> statuses;   // Status code -> replies
+};
+
+// Everything a load thread needs to build requests
+struct BenchPlan {
+    BenchOptions options;
+    struct sockaddr_in address;
+    bool framed;
+    int window;
+};
+
+// Function to open a non-blocking connection; completion is signalled by EPOLLOUT
+int bench_connect(const BenchPlan& plan, int epoll_fd, BenchConnection* conn) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (fd < 0) return -1;
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    if (connect(fd, (const struct sockaddr*)&plan.address, sizeof(plan.address)) < 0 && errno != EINPROGRESS) {
+        close(fd);
+        return -1;
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.ptr = conn;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        close(fd);
+        return -1;
+    }
+    conn->fd = fd;
+    return fd;
+}
+
+// Function to drop a connection, counting its unanswered requests as errors
+void bench_disconnect(BenchConnection& conn, BenchStats& stats, bool failed) {
+    if (conn.fd >= 0) close(conn.fd);  // Also removes it from the epoll set
+    conn.fd = -1;
+    if (failed) stats.errors += conn.in_flight.size();
+    conn.in_flight.clear();
+    conn.in.clear();
+    conn.out.clear();
+    conn.out_offset = 0;
+}
+
+// Function to write as much pending output as the socket accepts
+bool bench_flush(BenchConnection& conn) {
+    while (conn.out_offset < conn.out.size()) {
+        ssize_t n = send(conn.fd, conn.out.data() + conn.out_offset, conn.out.size() - conn.out_offset, MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.out_offset += n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+    conn.out.clear();
+    conn.out_offset = 0;
+    return true;
+}
+
+bool bench_can_send(const BenchPlan& plan, const BenchConnection& conn) {
+    if (plan.framed) return static_cast<int>(conn.in_flight.size()) < plan.window;
+    return conn.fd < 0;  // Legacy protocol: one connection per request
+}
+
+// Function to queue one request drawn from the configured mix
+void bench_send(const BenchPlan& plan, int epoll_fd, BenchConnection& conn, BenchStats& stats,
+                std::mt19937_64& rng, uint64_t& next_request_id, uint64_t start_ns) {
+    const int* mix = plan.options.mix;
+    int pick = static_cast<int>(rng() % static_cast<uint64_t>(mix[0] + mix[1] + mix[2]));
+    int slot = pick < mix[0] ? 0 : pick < mix[0] + mix[1] ? 1 : 2;
+    int id = plan.options.first_id + static_cast<int>(rng() % static_cast<uint64_t>(plan.options.id_count));
+
+    ClientMessage request;
+    switch (slot) {
+        case 0:
+            request.set_type(REGISTRATION_REQUEST);
+            request.mutable_reg_req()->set_id(id);
+            break;
+        case 1:
+            request.set_type(PDU_SESSION_REQUEST);
+            request.mutable_pdu_req()->set_id(id);
+            request.mutable_pdu_req()->set_sst(plan.options.sst);
+            request.mutable_pdu_req()->set_sd(plan.options.sd);
+            break;
+        default:
+            request.set_type(DEREGISTRATION_REQUEST);
+            request.mutable_dereg_req()->set_id(id);
+            break;
+    }
+    uint64_t request_id = next_request_id++;
+    request.set_request_id(request_id);
+
+    if (conn.fd < 0) {
+        if (bench_connect(plan, epoll_fd, &conn) < 0) {
+            ++stats.errors;
+            return;
+        }
+    }
+    if (plan.framed) {
+        append_frame(request, conn.out);
+    } else {
+        request.AppendToString(&conn.out);
+    }
+    conn.in_flight[request_id] = BenchRequest{start_ns, slot};
+}
+
+// Function to record one decoded reply
+void bench_complete(BenchConnection& conn, BenchStats& stats, const ServerMessage& reply, uint64_t now) {
+    auto it = conn.in_flight.find(reply.request_id());
+    if (it == conn.in_flight.end()) {
+        ++stats.errors;
+        return;
+    }
+    int status = reply.has_reg_ack() ? reply.reg_ack().status()
+               : reply.has_pdu_ack() ? reply.pdu_ack().status()
+               : reply.dereg_ack().status();
+    stats.latency[it->second.slot].record(now - it->second.start_ns);
+    ++stats.statuses[status];
+    ++stats.completed;
+    conn.in_flight.erase(it);
+}
+
+// Function to read and decode every reply available on a connection.
+// Returns false if the connection has to be dropped.
+bool bench_receive(const BenchPlan& plan, BenchConnection& conn, BenchStats& stats, ServerMessage& reply) {
+    char buffer[BENCH_READ_CHUNK];
+    bool eof = false;
+    while (true) {
+        ssize_t n = recv(conn.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            conn.in.append(buffer, n);
+        } else if (n == 0) {
+            eof = true;
+            break;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    uint64_t now = monotonic_ns();
+
+    if (!plan.framed) {
+        // Legacy protocol: the reply is complete once the server closes
+        if (!eof) return true;
+        if (!reply.ParseFromString(conn.in)) return false;
+        bench_complete(conn, stats, reply, now);
+        bench_disconnect(conn, stats, false);
+        return true;
+    }
+
+    size_t offset = 0;
+    const char* payload;
+    size_t len;
+    int status;
+    while ((status = next_frame(conn.in, offset, payload, len)) > 0) {
+        if (!reply.ParseFromArray(payload, static_cast<int>(len))) return false;
+        bench_complete(conn, stats, reply, now);
+        offset += FRAME_HEADER_SIZE + len;
+    }
+    conn.in.erase(0, offset);
+    return status == 0 && !eof;
+}
+
+// Body of one load thread
+void bench_thread(const BenchPlan& plan, int index, BenchStats& stats) {
+    const BenchOptions& options = plan.options;
+    std::mt19937_64 rng(0x9E3779B97F4A7C15ull * (index + 1));
+    uint64_t next_request_id = 1;
+    std::vector<BenchConnection> connections(options.connections);
+    ServerMessage reply;
+
+    int epoll_fd = epoll_create1(0);
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    if (epoll_fd < 0 || timer_fd < 0) {
+        perror("bench setup failed");
+        return;
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;  // nullptr marks the timer
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev);
+
+    bool open_loop = options.rate > 0;
+    uint64_t start = monotonic_ns();
+    uint64_t end = start + uint64_t(options.duration) * 1000000000ull;
+    // Open loop: each connection runs at an equal share of the rate,
+    // staggered so the connections do not fire together
+    uint64_t interval = open_loop ? static_cast<uint64_t>(1e9 * options.threads * options.connections / options.rate) : 0;
+    for (int i = 0; i < options.connections; ++i) {
+        connections[i].next_due_ns = start + interval * (index * options.connections + i) /
+                                             (options.threads * options.connections);
+    }
+
+    std::vector<struct epoll_event> events(BENCH_EVENTS);
+    while (true) {
+        uint64_t now = monotonic_ns();
+        if (now >= end) break;
+
+        // Queue whatever is due and flush it
+        uint64_t next_wakeup = end;
+        for (BenchConnection& conn : connections) {
+            if (open_loop) {
+                for (; conn.next_due_ns <= now; conn.next_due_ns += interval) conn.overdue.push_back(conn.next_due_ns);
+                while (!conn.overdue.empty() && bench_can_send(plan, conn)) {
+                    bench_send(plan, epoll_fd, conn, stats, rng, next_request_id, conn.overdue.front());
+                    conn.overdue.pop_front();
+                }
+                next_wakeup = std::min(next_wakeup, conn.next_due_ns);
+            } else {
+                while (bench_can_send(plan, conn)) {
+                    size_t before = conn.in_flight.size();
+                    bench_send(plan, epoll_fd, conn, stats, rng, next_request_id, now);
+                    if (conn.in_flight.size() == before) break;  // Could not connect
+                }
+            }
+            if (conn.fd >= 0 && !bench_flush(conn)) bench_disconnect(conn, stats, true);
+        }
+
+        struct itimerspec timer = {};
+        timer.it_value.tv_sec = static_cast<time_t>(next_wakeup / 1000000000ull);
+        timer.it_value.tv_nsec = static_cast<long>(next_wakeup % 1000000000ull);
+        timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &timer, nullptr);
+
+        int n = epoll_wait(epoll_fd, events.data(), BENCH_EVENTS, -1);
+        for (int i = 0; i < n; ++i) {
+            BenchConnection* conn = static_cast<BenchConnection*>(events[i].data.ptr);
+            if (conn == nullptr) {
+                uint64_t expirations;
+                (void)!read(timer_fd, &expirations, sizeof(expirations));
+                continue;
+            }
+            if (conn->fd < 0) continue;
+            bool ok = !(events[i].events & EPOLLERR);
+            if (ok && (events[i].events & EPOLLOUT)) ok = bench_flush(*conn);
+            if (ok && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))) ok = bench_receive(plan, *conn, stats, reply);
+            if (!ok) bench_disconnect(*conn, stats, true);
+        }
+    }
+
+    for (BenchConnection& conn : connections) {
+        stats.unsent += conn.overdue.size();
+        bench_disconnect(conn, stats, false);  // Unanswered at the deadline; not errors
+    }
+    close(timer_fd);
+    close(epoll_fd);
+}
+
+// Function to run the load generator and print throughput and latency percentiles
+void run_bench(const std::string& server_ip, int port, const BenchOptions& options, bool framed, int window) {
+    BenchPlan plan;
+    plan.options = options;
+    plan.framed = framed;
+    plan.window = window;
+    std::memset(&plan.address, 0, sizeof(plan.address));
+    plan.address.sin_family = AF_INET;
+    plan.address.sin_port = htons(port);
+    if (inet_pton(AF_INET, server_ip.c_str(), &plan.address.sin_addr) <= 0) {
+        std::cerr << "Invalid address" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::cout << "Benchmark: " << options.threads << " thread(s) x " << options.connections << " connection(s), "
+              << (framed ? "framed, window " + std::to_string(window) : std::string("one connection per request"))
+              << ", " << (options.rate > 0 ? "open loop at " + std::to_string(static_cast<long>(options.rate)) + " req/s"
+                                           : std::string("closed loop"))
+              << ", mix " << options.mix[0] << ":" << options.mix[1] << ":" << options.mix[2]
+              << ", IDs " << options.first_id << "-" << options.first_id + options.id_count - 1
+              << ", " << options.duration << " s" << std::endl;
+
+    std::vector<std::unique_ptr<BenchStats>> stats;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < options.threads; ++i) {
+        stats.emplace_back(new BenchStats());
+        threads.emplace_back(bench_thread, std::cref(plan), i, std::ref(*stats.back()));
+    }
+    for (auto& t : threads) t.join();
+
+    uint64_t completed = 0, errors = 0, unsent = 0;
+    std::map<int, uint64_t> statuses;
+    for (const auto& s : stats) {
+        completed += s->completed;
+        errors += s->errors;
+        unsent += s->unsent;
+        for (const auto& entry : s->statuses) statuses[entry.first] += entry.second;
+    }
+
+    printf("Requests: %llu completed, %llu errors, %.1f req/s\n", static_cast<unsigned long long>(completed),
+           static_cast<unsigned long long>(errors), completed / double(options.duration));
+    if (unsent > 0) {
+        printf("Behind schedule: %llu requests never sent; the target rate was not reached\n",
+               static_cast<unsigned long long>(unsent));
+    }
+    std::string out = "Status:";
+    for (const auto& entry : statuses) out += " " + std::to_string(entry.first) + "=" + std::to_string(entry.second);
+    out += "\n";
+    out += LATENCY_HEADER;
+
+    static const char* const slot_names[] = {"REGISTRATION_REQUEST", "PDU_SESSION_REQUEST", "DEREGISTRATION_REQUEST"};
+    std::unique_ptr<HistogramSnapshot> all(new HistogramSnapshot());
+    for (int slot = 0; slot < 3; ++slot) {
+        std::unique_ptr<HistogramSnapshot> snapshot(new HistogramSnapshot());
+        for (const auto& s : stats) {
+            s->latency[slot].add_to(*snapshot);
+            s->latency[slot].add_to(*all);
+        }
+        if (snapshot->count > 0) append_latency_line(out, slot_names[slot], *snapshot);
+    }
+    append_latency_line(out, "all", *all);
+    std::cout << out << std::flush;
+}
+
 // Parse command-line arguments
-void parse_arguments(int argc, char* argv[], std::string& server_ip, int& port, ClientMessage& message) {
+void parse_arguments(int argc, char* argv[], std::string& server_ip, int& port, ClientMessage& message,
+                     bool& framed, int& count, int& window, int& batch_size, BenchOptions& bench) {
+    static const struct option long_options[] = {
+        {"bench",       no_argument,       nullptr, 'B'},
+        {"threads",     required_argument, nullptr, 'T'},
+        {"connections", required_argument, nullptr, 'C'},
+        {"mix",         required_argument, nullptr, 'M'},
+        {"ids",         required_argument, nullptr, 'I'},
+        {"rate",        required_argument, nullptr, 'R'},
+        {"duration",    required_argument, nullptr, 'D'},
+        {nullptr, 0, nullptr, 0}
+    };
+
     int option;
     std::string type;
     int id = -1, sst = -1;
     std::string sd = "";
 
-    while ((option = getopt(argc, argv, "h:p:t:i:s:d:")) != -1) {
+    while ((option = getopt_long(argc, argv, "h:p:t:i:s:d:fn:w:b:BT:C:M:I:R:D:", long_options, nullptr)) != -1) {
         switch (option) {
             case 'h':
                 server_ip = optarg;
@@ -83,12 +593,62 @@ void parse_arguments(int argc, char* argv[], std::string& server_ip, int& port,
             case 'd':
                 sd = optarg;
                 break;
+            case 'f':
+                framed = true;
+                break;
+            case 'n':
+                count = std::stoi(optarg);
+                break;
+            case 'w':
+                window = std::max(1, std::stoi(optarg));
+                break;
+            case 'b':
+                batch_size = std::max(1, std::stoi(optarg));
+                break;
+            case 'B':
+                bench.enabled = true;
+                break;
+            case 'T':
+                bench.threads = std::max(1, std::stoi(optarg));
+                break;
+            case 'C':
+                bench.connections = std::max(1, std::stoi(optarg));
+                break;
+            case 'M':
+                if (sscanf(optarg, "%d:%d:%d", &bench.mix[0], &bench.mix[1], &bench.mix[2]) != 3 ||
+                    bench.mix[0] < 0 || bench.mix[1] < 0 || bench.mix[2] < 0 ||
+                    bench.mix[0] + bench.mix[1] + bench.mix[2] == 0) {
+                    std::cerr << "Invalid mix: " << optarg << " (expected reg:pdu:dereg weights, e.g. 60:30:10)" << std::endl;
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'I':
+                bench.id_count = std::max(1, std::stoi(optarg));
+                break;
+            case 'R':
+                bench.rate = std::max(0.0, std::stod(optarg));
+                break;
+            case 'D':
+                bench.duration = std::max(1, std::stoi(optarg));
+                break;
             default:
-                std::cerr << "Usage: " << argv[0] << " [-h server_ip] [-p port] [-t message_type] [-i id] [-s sst] [-d sd]" << std::endl;
+                std::cerr << "Usage: " << argv[0] << " [-h server_ip] [-p port] [-t message_type] [-i id] [-s sst] [-d sd]"
+                          << " [-f] [-n count] [-w window] [-b batch_size]" << std::endl
+                          << "       " << argv[0] << " --bench [-h server_ip] [-p port] [-f] [-w window] [-i first_id]"
+                          << " [--ids N] [--threads N] [--connections N] [--mix reg:pdu:dereg] [--rate req/s]"
+                          << " [--duration seconds] [-s sst] [-d sd]" << std::endl;
                 exit(EXIT_FAILURE);
         }
     }
 
+    if (bench.enabled) {
+        // The request mix replaces -t; IDs start at -i
+        if (id != -1) bench.first_id = id;
+        if (sst != -1) bench.sst = sst;
+        if (!sd.empty()) bench.sd = sd;
+        return;
+    }
+
     // Set the message based on type and additional parameters
     if (type == "REGISTRATION_REQUEST") {
         message.set_type(REGISTRATION_REQUEST);
@@ -130,12 +690,35 @@ int main(int argc, char* argv[]) {
     std::string server_ip = DEFAULT_SERVER_IP;
     int port = DEFAULT_PORT;
     ClientMessage request;
+    bool framed = false;
+    int count = 1;
+    int window = 1;
+    int batch_size = 1;
+    BenchOptions bench;
 
     // Parse command-line arguments
-    parse_arguments(argc, argv, server_ip, port, request);
+    parse_arguments(argc, argv, server_ip, port, request, framed, count, window, batch_size, bench);
+
+    if (bench.enabled) {
+        run_bench(server_ip, port, bench, framed, window);
+        google::protobuf::ShutdownProtobufLibrary();
+        return 0;
+    }
+
+    if (batch_size > 1 && !framed) {
+        std::cerr << "Batches (-b) require the framed protocol (-f)" << std::endl;
+        exit(EXIT_FAILURE);
+    }
 
     // Send the constructed request
-    send_request(server_ip, port, request);
+    if (framed) {
+        send_framed_requests(server_ip, port, request, count, window, batch_size);
+    } else {
+        if (!send_request(server_ip, port, request)) {
+            google::protobuf::ShutdownProtobufLibrary();
+            return EXIT_FAILURE;
+        }
+    }
 
     google::protobuf::ShutdownProtobufLibrary();
     return 0;
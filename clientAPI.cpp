@@ -1,104 +1,274 @@
 #include <iostream>
 #include <sstream>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <getopt.h>
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
+#include "rest_client.h"
+#include "metrics.h"
 
 using json = nlohmann::json;
 using namespace std;
 
 const std::string SERVER_URL = "http://server:8081";
 
-// Callback function for handling response
-size_t WriteCallback(void *contents, size_t size, size_t nmemb, std::string *output) {
-    size_t totalSize = size * nmemb;
-    output->append((char *)contents, totalSize);
-    return totalSize;
-}
+RestClient* client = nullptr;  // Reused for every request, so the connection stays open
 
 // Function to send HTTP POST request
-std::string sendPostRequest(const std::string &url, const json &data) {
-    CURL *curl = curl_easy_init();
-    if (!curl) {
-        cerr << "Failed to initialize CURL" << endl;
-        return "";
-    }
-
-    std::string response;
-    struct curl_slist *headers = NULL;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_POST, 1L);
-    std::string jsonData = data.dump();
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, jsonData.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-        cerr << "CURL request failed: " << curl_easy_strerror(res) << endl;
+std::string sendPostRequest(const std::string &path, const json &data) {
+    RestRequest request;
+    request.path = path;
+    request.body = data.dump();
+    RestResponse response = client->send(request);
+    if (response.code == 0) {
+        cerr << "CURL request failed: " << response.error << endl;
     }
-
-    curl_easy_cleanup(curl);
-    curl_slist_free_all(headers);
-    return response;
+    return response.body;
 }
 
 // Function to register a user
 void registerUser(int id) {
     json requestData = {{"id", id}};
-    std::string response = sendPostRequest(SERVER_URL + "/register", requestData);
+    std::string response = sendPostRequest("/register", requestData);
     cout << "Response: " << response << endl;
 }
 
 // Function to initiate PDU session
 void pduSession(int id, int sst, const std::string &sd) {
     json requestData = {{"id", id}, {"sst", sst}, {"sd", sd}};
-    std::string response = sendPostRequest(SERVER_URL + "/pdu-session", requestData);
+    std::string response = sendPostRequest("/pdu-session", requestData);
     cout << "Response: " << response << endl;
 }
 
 // Function to send DELETE request
-std::string sendDeleteRequest(const std::string &url, const json &data) {
-    CURL *curl = curl_easy_init();
-    if (!curl) {
-        cerr << "Failed to initialize CURL" << endl;
-        return "";
+std::string sendDeleteRequest(const std::string &path, const json &data) {
+    RestRequest request;
+    request.isDelete = true;
+    request.path = path;
+    request.body = data.dump();
+    RestResponse response = client->send(request);
+    if (response.code == 0) {
+        cerr << "CURL request failed: " << response.error << endl;
     }
-
-    std::string response;
-    struct curl_slist *headers = NULL;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE"); // DELETE method
-    std::string jsonData = data.dump();
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, jsonData.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-        cerr << "CURL request failed: " << curl_easy_strerror(res) << endl;
-    }
-
-    curl_easy_cleanup(curl);
-    curl_slist_free_all(headers);
-    return response;
+    return response.body;
 }
 
 // Updated Deregister Function
 void deregisterUser(int id) {
     json requestData = {{"id", id}};
-    std::string response = sendDeleteRequest(SERVER_URL + "/deregister", requestData);
+    std::string response = sendDeleteRequest("/deregister", requestData);
     cout << "Response: " << response << endl;
 }
 
+// Non-interactive load settings (--bench / --trace)
+struct BenchOptions {
+    bool enabled = false;
+    std::string trace;            // JSONL trace to send instead of the mix
+    int requests = 10000;
+    int concurrency = 16;         // Requests in flight (one keep-alive connection each)
+    int mix[3] = {100, 0, 0};     // Weights of /register, /pdu-session, /deregister
+    int firstId = 1;              // IDs are drawn uniformly from [firstId, firstId + idCount)
+    int idCount = 1000;
+    int sst = 1;
+    std::string sd = "0001";
+};
+
+// Request slots, in the order of the mix
+static const char* const slotNames[] = {"/register", "/pdu-session", "/deregister"};
+
+RestRequest makeRequest(int slot, int id, int sst, const std::string& sd) {
+    RestRequest request;
+    request.path = slotNames[slot];
+    request.isDelete = slot == 2;
+    if (slot == 1) {
+        request.body = "{\"id\":" + std::to_string(id) + ",\"sst\":" + std::to_string(sst) + ",\"sd\":\"" + sd + "\"}";
+    } else {
+        request.body = "{\"id\":" + std::to_string(id) + "}";
+    }
+    return request;
+}
+
+// Function to draw 'requests' requests from the mix and ID range
+void buildMixRequests(const BenchOptions& options, std::vector<RestRequest>& requests, std::vector<int>& slots) {
+    std::mt19937_64 rng(0x9E3779B97F4A7C15ull);
+    int total = options.mix[0] + options.mix[1] + options.mix[2];
+    for (int i = 0; i < options.requests; ++i) {
+        int pick = static_cast<int>(rng() % static_cast<uint64_t>(total));
+        int slot = pick < options.mix[0] ? 0 : pick < options.mix[0] + options.mix[1] ? 1 : 2;
+        int id = options.firstId + static_cast<int>(rng() % static_cast<uint64_t>(options.idCount));
+        requests.push_back(makeRequest(slot, id, options.sst, options.sd));
+        slots.push_back(slot);
+    }
+}
+
+// Function to load a JSONL trace in the replay tool's format; "ts" is ignored
+bool loadTraceRequests(const std::string& path, std::vector<RestRequest>& requests, std::vector<int>& slots) {
+    std::ifstream file(path);
+    if (!file) {
+        cerr << "Cannot open trace " << path << endl;
+        return false;
+    }
+    static const std::map<std::string, int> types = {
+        {"REGISTRATION_REQUEST", 0}, {"PDU_SESSION_REQUEST", 1}, {"DEREGISTRATION_REQUEST", 2}};
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        try {
+            json entry = json::parse(line);
+            auto type = types.find(entry.at("type").get<std::string>());
+            if (type == types.end()) throw std::runtime_error("unknown type");
+            int slot = type->second;
+            int sst = slot == 1 ? entry.at("sst").get<int>() : 0;
+            std::string sd = slot == 1 ? entry.at("sd").get<std::string>() : "";
+            requests.push_back(makeRequest(slot, entry.at("id").get<int>(), sst, sd));
+            slots.push_back(slot);
+        } catch (const std::exception& e) {
+            cerr << path << ":" << lineNumber << ": " << e.what() << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Function to fire the requests concurrently and print throughput and latency percentiles
+int runBench(const std::string& url, const BenchOptions& options) {
+    std::vector<RestRequest> requests;
+    std::vector<int> slots;
+    if (!options.trace.empty()) {
+        if (!loadTraceRequests(options.trace, requests, slots)) return EXIT_FAILURE;
+    } else {
+        buildMixRequests(options, requests, slots);
+    }
+
+    cout << "Benchmark: " << requests.size() << " requests to " << url << ", concurrency "
+         << options.concurrency << ", ";
+    if (!options.trace.empty()) {
+        cout << "trace " << options.trace << endl;
+    } else {
+        cout << "mix " << options.mix[0] << ":" << options.mix[1] << ":" << options.mix[2] << ", IDs "
+             << options.firstId << "-" << options.firstId + options.idCount - 1 << endl;
+    }
+
+    std::unique_ptr<LatencyHistogram[]> latency(new LatencyHistogram[3]);
+    std::map<int, uint64_t> statuses;  // Body "status" of 200 replies, else the HTTP code
+    uint64_t completed = 0, errors = 0;
+    uint64_t start = monotonic_ns();
+    client->sendBatch(requests, options.concurrency, [&](size_t index, RestResponse& response) {
+        if (response.code == 0) {
+            ++errors;
+            return;
+        }
+        int status = static_cast<int>(response.code);
+        size_t field = response.body.find("\"status\":");
+        if (status == 200 && field != std::string::npos) status = std::atoi(response.body.c_str() + field + 9);
+        ++statuses[status];
+        ++completed;
+        latency[slots[index]].record(static_cast<uint64_t>(response.seconds * 1e9));
+    });
+    double elapsed = (monotonic_ns() - start) / 1e9;
+
+    printf("Requests: %llu completed, %llu errors, %.3f s, %.1f req/s\n", static_cast<unsigned long long>(completed),
+           static_cast<unsigned long long>(errors), elapsed, completed / elapsed);
+    std::string out = "Status:";
+    for (const auto& entry : statuses) out += " " + std::to_string(entry.first) + "=" + std::to_string(entry.second);
+    out += "\n";
+    out += LATENCY_HEADER;
+    std::unique_ptr<HistogramSnapshot> all(new HistogramSnapshot());
+    for (int slot = 0; slot < 3; ++slot) {
+        std::unique_ptr<HistogramSnapshot> snapshot(new HistogramSnapshot());
+        latency[slot].add_to(*snapshot);
+        latency[slot].add_to(*all);
+        if (snapshot->count > 0) append_latency_line(out, slotNames[slot], *snapshot);
+    }
+    append_latency_line(out, "all", *all);
+    cout << out << std::flush;
+    return errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// Parse command-line arguments; without --bench or --trace the interactive menu runs
+void parseArguments(int argc, char* argv[], std::string& url, BenchOptions& bench) {
+    static const struct option longOptions[] = {
+        {"url",         required_argument, nullptr, 'u'},
+        {"bench",       no_argument,       nullptr, 'B'},
+        {"trace",       required_argument, nullptr, 'F'},
+        {"requests",    required_argument, nullptr, 'n'},
+        {"concurrency", required_argument, nullptr, 'c'},
+        {"mix",         required_argument, nullptr, 'M'},
+        {"first-id",    required_argument, nullptr, 'i'},
+        {"ids",         required_argument, nullptr, 'I'},
+        {"sst",         required_argument, nullptr, 's'},
+        {"sd",          required_argument, nullptr, 'd'},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    int opt;
+    while ((opt = getopt_long(argc, argv, "u:BF:n:c:M:i:I:s:d:", longOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 'u':
+                url = optarg;
+                break;
+            case 'B':
+                bench.enabled = true;
+                break;
+            case 'F':
+                bench.enabled = true;
+                bench.trace = optarg;
+                break;
+            case 'n':
+                bench.requests = std::max(1, std::stoi(optarg));
+                break;
+            case 'c':
+                bench.concurrency = std::max(1, std::stoi(optarg));
+                break;
+            case 'M':
+                if (sscanf(optarg, "%d:%d:%d", &bench.mix[0], &bench.mix[1], &bench.mix[2]) != 3 ||
+                    bench.mix[0] < 0 || bench.mix[1] < 0 || bench.mix[2] < 0 ||
+                    bench.mix[0] + bench.mix[1] + bench.mix[2] == 0) {
+                    cerr << "Invalid mix: " << optarg << " (expected reg:pdu:dereg weights, e.g. 60:30:10)" << endl;
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'i':
+                bench.firstId = std::stoi(optarg);
+                break;
+            case 'I':
+                bench.idCount = std::max(1, std::stoi(optarg));
+                break;
+            case 's':
+                bench.sst = std::stoi(optarg);
+                break;
+            case 'd':
+                bench.sd = optarg;
+                break;
+            default:
+                cerr << "Usage: " << argv[0] << " [--url URL]" << endl
+                     << "       " << argv[0] << " --bench [--url URL] [--requests N] [--concurrency N]"
+                     << " [--mix reg:pdu:dereg] [--first-id N] [--ids N] [--sst N] [--sd SD]" << endl
+                     << "       " << argv[0] << " --trace trace.jsonl [--url URL] [--concurrency N]" << endl;
+                exit(EXIT_FAILURE);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string url = SERVER_URL;
+    BenchOptions bench;
+    parseArguments(argc, argv, url, bench);
 
-int main() {
     curl_global_init(CURL_GLOBAL_ALL);
+    client = new RestClient(url);
+
+    if (bench.enabled) {
+        int status = runBench(url, bench);
+        delete client;
+        curl_global_cleanup();
+        return status;
+    }
 
     int choice, id, sst;
     std::string sd;
@@ -121,7 +291,7 @@ int main() {
             cin >> id;
             cout << "Enter SST (1-255): ";
             cin >> sst;
-            cout << "Enter SD (4-bit binary, e.g., 0001): ";
+            cout << "Enter SD (4 hexadecimal digits, e.g., 0a1f): ";
             cin >> sd;
             pduSession(id, sst, sd);
         } else if (choice == 3) {
@@ -135,6 +305,7 @@ int main() {
         }
     }
 
+    delete client;
     curl_global_cleanup();
     return 0;
 }
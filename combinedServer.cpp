@@ -0,0 +1,181 @@
+// One process serving both front-ends on one in-memory state: the protobuf
+// TCP server (tcp_server.h) and the REST server (rest_server.h) apply every
+// request to the same SubscriberCore, so a user registered over TCP can open
+// a PDU session over REST and the metrics count both.
+#include <iostream>
+#include <cstdlib>
+#include <getopt.h>
+#include <csignal>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "tcp_server.h"
+#include "rest_server.h"
+
+#define COMBINED_TCP_PORT 8082
+
+SubscriberCore subscriber_core;  // Registration and PDU session state, shared by both front-ends
+ResponseCache response_cache;    // Pre-encoded protobuf acks, built once in main
+
+// REST settings; the TCP ones live in server_options
+struct RestOptions {
+    int port = REST_DEFAULT_PORT;
+    size_t workers = 0;          // 0 = one per hardware thread
+    size_t maxRequestSize = 0;   // 0 = Pistache's default
+};
+
+// Function to handle command-line arguments
+void parse_arguments(int argc, char** argv, ServerOptions& tcp, RestOptions& rest) {
+    static const struct option long_options[] = {
+        {"tcp-port",         required_argument, nullptr, 'p'},
+        {"rest-port",        required_argument, nullptr, 'P'},
+        {"io-threads",       required_argument, nullptr, 't'},
+        {"workers",          required_argument, nullptr, 'w'},
+        {"backlog",          required_argument, nullptr, 'b'},
+        {"reuseport",        no_argument,       nullptr, 'r'},
+        {"pin-cpus",         no_argument,       nullptr, 'c'},
+        {"io-engine",        required_argument, nullptr, 'e'},
+        {"framed",           no_argument,       nullptr, 'f'},
+        {"max-request-size", required_argument, nullptr, 'M'},
+        {"store",            required_argument, nullptr, 's'},
+        {"log-level",        required_argument, nullptr, 'l'},
+        {"admin-port",       required_argument, nullptr, 'a'},
+        {"metrics-interval", required_argument, nullptr, 'm'},
+        {"wal",              required_argument, nullptr, 'W'},
+        {"wal-commit-us",    required_argument, nullptr, 'u'},
+        {"snapshot",         required_argument, nullptr, 'S'},
+        {"snapshot-interval", required_argument, nullptr, 'i'},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    tcp.port = COMBINED_TCP_PORT;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "p:P:t:w:b:rce:fM:s:l:a:m:W:u:S:i:", long_options, nullptr)) != -1) {
+        switch (opt) {
+            case 'p':
+                tcp.port = std::stoi(optarg);
+                break;
+            case 'P':
+                rest.port = std::stoi(optarg);
+                break;
+            case 't':
+                tcp.io_threads = std::stoi(optarg);
+                break;
+            case 'w':
+                rest.workers = static_cast<size_t>(std::max(1, std::stoi(optarg)));
+                break;
+            case 'b':
+                tcp.backlog = std::stoi(optarg);
+                break;
+            case 'r':
+                tcp.reuse_port = true;
+                break;
+            case 'c':
+                tcp.pin_threads = true;
+                break;
+            case 'e':
+                if (std::string(optarg) == "io_uring") {
+                    tcp.io_uring = true;
+                } else if (std::string(optarg) != "epoll") {
+                    std::cerr << "Unknown I/O engine: " << optarg << " (expected epoll or io_uring)\n";
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'f':
+                tcp.framed = true;
+                break;
+            case 'M':
+                rest.maxRequestSize = static_cast<size_t>(std::max(0L, std::stol(optarg)));
+                break;
+            case 's':
+                tcp.store = optarg;
+                break;
+            case 'l':
+                if (!parse_log_level(optarg, tcp.log_level)) {
+                    std::cerr << "Unknown log level: " << optarg << " (expected debug, info, warn, error or off)\n";
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'a':
+                tcp.admin_port = std::stoi(optarg);
+                break;
+            case 'm':
+                tcp.metrics_interval = std::stoi(optarg);
+                break;
+            case 'W':
+                tcp.wal_path = optarg;
+                break;
+            case 'u':
+                tcp.wal_commit_us = std::stoi(optarg);
+                break;
+            case 'S':
+                tcp.snapshot_path = optarg;
+                break;
+            case 'i':
+                tcp.snapshot_interval = std::stoi(optarg);
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [--tcp-port N] [--rest-port N] [--io-threads N] [--workers N]"
+                          << " [--backlog N] [--reuseport] [--pin-cpus] [--io-engine epoll|io_uring] [--framed]"
+                          << " [--max-request-size BYTES] [--store sharded|bitmap]"
+                          << " [--log-level debug|info|warn|error|off] [--admin-port N] [--metrics-interval SECONDS]"
+                          << " [--wal PATH] [--wal-commit-us N] [--snapshot PATH] [--snapshot-interval SECONDS]\n";
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    size_t hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    if (tcp.io_threads <= 0) tcp.io_threads = static_cast<int>(hardware_threads);
+    if (rest.workers == 0) rest.workers = hardware_threads;
+}
+
+int main(int argc, char** argv) {
+    GOOGLE_PROTOBUF_VERIFY_VERSION;
+
+    ServerOptions& options = server_options;
+    RestOptions rest;
+    parse_arguments(argc, argv, options, rest);
+    log_level().store(options.log_level);
+    signal(SIGUSR1, adjust_log_level);
+    signal(SIGUSR2, adjust_log_level);
+
+    if (!subscriber_core.init(options.store)) {
+        std::cerr << "Unknown store backend: " << options.store << " (expected sharded or bitmap)\n";
+        exit(EXIT_FAILURE);
+    }
+    if (!options.snapshot_path.empty() && !subscriber_core.load_snapshot(options.snapshot_path)) {
+        exit(EXIT_FAILURE);
+    }
+    if (!options.wal_path.empty() && !subscriber_core.open_wal(options.wal_path, options.wal_commit_us)) {
+        exit(EXIT_FAILURE);
+    }
+    if (!options.snapshot_path.empty() && options.snapshot_interval > 0) {
+        std::thread(&SubscriberCore::snapshot_loop, &subscriber_core, options.snapshot_path,
+                    options.snapshot_interval).detach();
+    }
+    response_cache.init();
+
+    std::vector<int> listeners;
+    std::vector<std::thread> io_threads;
+    if (!start_tcp_server(options, listeners, io_threads)) {
+        exit(EXIT_FAILURE);
+    }
+
+    Pistache::Address addr(Pistache::Ipv4::any(), Pistache::Port(static_cast<uint16_t>(rest.port)));
+    ServerAPI server(addr);
+    server.init(rest.workers, rest.maxRequestSize);
+    std::cout << "REST API Server running on port " << rest.port << " with " << rest.workers
+              << " worker thread(s)..." << std::endl;
+    if (options.pin_threads) {
+        // The workers start inside start(), which blocks
+        std::thread(pinWorkerThreads, rest.workers).detach();
+    }
+    server.start();
+
+    for (auto& t : io_threads) {
+        t.join();
+    }
+    for (int fd : listeners) close(fd);
+    google::protobuf::ShutdownProtobufLibrary();
+    return 0;
+}
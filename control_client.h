@@ -0,0 +1,536 @@
+// Asynchronous client for the protobuf server, for programs that issue many
+// control requests concurrently. One background I/O thread drives a pool of
+// non-blocking connections from an epoll loop; any thread may submit
+// requests and gets the reply through a callback or a std::future.
+//
+//   ControlClientOptions options;
+//   options.host = "127.0.0.1";
+//   options.port = 8082;
+//   ControlClient client(options);
+//   std::string error;
+//   if (!client.start(error)) { ... }
+//   std::future<ControlReply> reply = client.register_user(42);
+//   client.pdu_session(42, 1, "0001", [](const ControlReply& r) { ... });
+//
+// With 'framed' (server started with --framed) every pooled connection is
+// persistent and pipelines up to 'window' requests; replies are matched by
+// request_id. Without it each request uses its own connection, as the
+// legacy protocol requires, and 'connections' caps how many run at once.
+// Requests beyond the pool's capacity wait in submission order.
+//
+// Failures never throw or exit: a request that cannot be sent, is not
+// answered within 'timeout_ms' or whose connection drops completes with
+// status 0 and the reason in 'message'. Callbacks run on the I/O thread and
+// must not block; futures are completed from there too.
+#ifndef CONTROL_CLIENT_H
+#define CONTROL_CLIENT_H
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <unistd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include "message.pb.h"
+#include "framing.h"
+#include "metrics.h"
+
+#define CONTROL_CLIENT_EVENTS 256      // epoll events handled per wakeup
+#define CONTROL_CLIENT_READ_CHUNK 16384
+
+struct ControlClientOptions {
+    std::string host = "127.0.0.1";
+    int port = 8081;
+    bool framed = true;       // Persistent framed connections (server --framed)
+    int connections = 4;      // Pool size
+    int window = 64;          // Requests in flight per framed connection
+    int timeout_ms = 5000;    // Per request, from submission to reply
+};
+
+struct ControlReply {
+    int status = 0;           // Ack status (200, 400, 403, 409), or 0 if the request failed
+    int pdu_id = 0;           // PDU_SESSION_ACK only
+    std::string message;      // Ack status_message, or why the request failed
+
+    bool failed() const { return status == 0; }
+};
+
+typedef std::function<void(const ControlReply&)> ReplyCallback;
+
+class ControlClient {
+public:
+    explicit ControlClient(const ControlClientOptions& options) : options_(options) {
+        if (options_.connections < 1) options_.connections = 1;
+        if (options_.window < 1 || !options_.framed) options_.window = 1;
+    }
+
+    // Fails every outstanding request with "client closed"
+    ~ControlClient() {
+        if (io_thread_.joinable()) {
+            stop_.store(true, std::memory_order_release);
+            wake();
+            io_thread_.join();
+        }
+        if (epoll_fd_ >= 0) close(epoll_fd_);
+        if (wake_fd_ >= 0) close(wake_fd_);
+    }
+
+    ControlClient(const ControlClient&) = delete;
+    ControlClient& operator=(const ControlClient&) = delete;
+
+    // Resolves the server address and starts the I/O thread. Connections are
+    // opened on demand. Returns false with 'error' set on failure.
+    bool start(std::string& error) {
+        struct addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        struct addrinfo* result = nullptr;
+        int rc = getaddrinfo(options_.host.c_str(), std::to_string(options_.port).c_str(), &hints, &result);
+        if (rc != 0) {
+            error = "Cannot resolve " + options_.host + ": " + gai_strerror(rc);
+            return false;
+        }
+        std::memcpy(&address_, result->ai_addr, sizeof(address_));
+        freeaddrinfo(result);
+
+        epoll_fd_ = epoll_create1(0);
+        wake_fd_ = eventfd(0, EFD_NONBLOCK);
+        if (epoll_fd_ < 0 || wake_fd_ < 0) {
+            error = std::string("Client setup failed: ") + strerror(errno);
+            return false;
+        }
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = nullptr;  // nullptr marks the wakeup eventfd
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+
+        connections_.resize(options_.connections);
+        io_thread_ = std::thread(&ControlClient::io_loop, this);
+        return true;
+    }
+
+    void register_user(int id, ReplyCallback callback) {
+        ClientMessage request;
+        request.set_type(REGISTRATION_REQUEST);
+        request.mutable_reg_req()->set_id(id);
+        send(request, std::move(callback));
+    }
+
+    void pdu_session(int id, int sst, const std::string& sd, ReplyCallback callback) {
+        ClientMessage request;
+        request.set_type(PDU_SESSION_REQUEST);
+        request.mutable_pdu_req()->set_id(id);
+        request.mutable_pdu_req()->set_sst(sst);
+        request.mutable_pdu_req()->set_sd(sd);
+        send(request, std::move(callback));
+    }
+
+    void deregister_user(int id, ReplyCallback callback) {
+        ClientMessage request;
+        request.set_type(DEREGISTRATION_REQUEST);
+        request.mutable_dereg_req()->set_id(id);
+        send(request, std::move(callback));
+    }
+
+    std::future<ControlReply> register_user(int id) {
+        std::shared_ptr<std::promise<ControlReply>> promise(new std::promise<ControlReply>());
+        register_user(id, [promise](const ControlReply& reply) { promise->set_value(reply); });
+        return promise->get_future();
+    }
+
+    std::future<ControlReply> pdu_session(int id, int sst, const std::string& sd) {
+        std::shared_ptr<std::promise<ControlReply>> promise(new std::promise<ControlReply>());
+        pdu_session(id, sst, sd, [promise](const ControlReply& reply) { promise->set_value(reply); });
+        return promise->get_future();
+    }
+
+    std::future<ControlReply> deregister_user(int id) {
+        std::shared_ptr<std::promise<ControlReply>> promise(new std::promise<ControlReply>());
+        deregister_user(id, [promise](const ControlReply& reply) { promise->set_value(reply); });
+        return promise->get_future();
+    }
+
+    // Sends any single request; its request_id is assigned here
+    void send(ClientMessage& request, ReplyCallback callback) {
+        Submission submission;
+        submission.request_id = next_request_id_.fetch_add(1, std::memory_order_relaxed);
+        submission.callback = std::move(callback);
+        request.set_request_id(submission.request_id);
+        if (options_.framed) {
+            append_frame(request, submission.data);
+        } else {
+            request.SerializeToString(&submission.data);
+        }
+        outstanding_.fetch_add(1, std::memory_order_relaxed);
+
+        bool was_empty;
+        {
+            std::lock_guard<std::mutex> lock(incoming_mutex_);
+            was_empty = incoming_.empty();
+            incoming_.push_back(std::move(submission));
+        }
+        if (was_empty) wake();  // Otherwise the I/O thread has a wakeup pending
+    }
+
+    std::future<ControlReply> send(ClientMessage& request) {
+        std::shared_ptr<std::promise<ControlReply>> promise(new std::promise<ControlReply>());
+        send(request, [promise](const ControlReply& reply) { promise->set_value(reply); });
+        return promise->get_future();
+    }
+
+    // Requests submitted and not yet completed; use it to bound the backlog
+    size_t outstanding() const { return outstanding_.load(std::memory_order_relaxed); }
+
+private:
+    struct Submission {
+        uint64_t request_id;
+        std::string data;            // Encoded request
+        ReplyCallback callback;
+    };
+
+    struct Pending {
+        ReplyCallback callback;
+        std::string data;            // Encoded request, until it is sent
+        int connection = -1;         // -1 while waiting for a free slot
+    };
+
+    struct Connection {
+        int fd = -1;
+        bool connected = false;
+        std::string out;
+        size_t out_offset = 0;
+        std::string in;
+        int in_flight = 0;
+        uint64_t legacy_request_id = 0;   // Legacy protocol: the one request on this connection
+    };
+
+    void wake() {
+        uint64_t one = 1;
+        (void)!write(wake_fd_, &one, sizeof(one));
+    }
+
+    void io_loop() {
+        std::vector<Submission> batch;
+        std::vector<struct epoll_event> events(CONTROL_CLIENT_EVENTS);
+        ServerMessage reply;
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(incoming_mutex_);
+                batch.swap(incoming_);
+            }
+            uint64_t now = monotonic_ns();
+            uint64_t deadline = now + uint64_t(options_.timeout_ms) * 1000000ull;
+            for (Submission& submission : batch) {
+                Pending& pending = pending_[submission.request_id];
+                pending.callback = std::move(submission.callback);
+                pending.data = std::move(submission.data);
+                backlog_.push_back(submission.request_id);
+                deadlines_.push_back(Deadline{deadline, submission.request_id});
+            }
+            batch.clear();
+
+            if (stop_.load(std::memory_order_acquire)) break;
+            expire(now);
+            dispatch();
+            for (size_t i = 0; i < connections_.size(); ++i) {
+                if (connections_[i].fd >= 0 && connections_[i].connected && !flush(connections_[i])) {
+                    fail_connection(static_cast<int>(i), "Connection lost");
+                }
+            }
+
+            int timeout = -1;
+            if (!deadlines_.empty()) {
+                uint64_t first = deadlines_.front().deadline_ns;
+                timeout = first <= now ? 0 : static_cast<int>((first - now + 999999) / 1000000);
+            }
+            int n = epoll_wait(epoll_fd_, events.data(), CONTROL_CLIENT_EVENTS, timeout);
+            for (int i = 0; i < n; ++i) {
+                if (events[i].data.ptr == nullptr) {
+                    uint64_t count;
+                    (void)!read(wake_fd_, &count, sizeof(count));
+                    continue;
+                }
+                int index = static_cast<int>(static_cast<Connection*>(events[i].data.ptr) - connections_.data());
+                handle_event(index, events[i].events, reply);
+            }
+        }
+
+        for (size_t i = 0; i < connections_.size(); ++i) close_connection(connections_[i]);
+        std::unordered_map<uint64_t, Pending> remaining;
+        remaining.swap(pending_);
+        for (auto& entry : remaining) complete(entry.second, failure("Client closed"));
+    }
+
+    void handle_event(int index, uint32_t events, ServerMessage& reply) {
+        Connection& conn = connections_[index];
+        if (conn.fd < 0) return;
+        if (events & EPOLLERR) {
+            int error = 0;
+            socklen_t len = sizeof(error);
+            getsockopt(conn.fd, SOL_SOCKET, SO_ERROR, &error, &len);
+            fail_connection(index, std::string(conn.connected ? "Connection lost: " : "Connection failed: ") +
+                                   strerror(error ? error : ECONNRESET));
+            return;
+        }
+        if ((events & EPOLLOUT) && !conn.connected) conn.connected = true;
+        if ((events & EPOLLOUT) && !flush(conn)) {
+            fail_connection(index, "Connection lost");
+            return;
+        }
+        if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) receive(index, reply);
+    }
+
+    // Function to read every reply available on a connection
+    void receive(int index, ServerMessage& reply) {
+        Connection& conn = connections_[index];
+        char buffer[CONTROL_CLIENT_READ_CHUNK];
+        bool eof = false;
+        while (true) {
+            ssize_t n = recv(conn.fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                conn.in.append(buffer, n);
+            } else if (n == 0) {
+                eof = true;
+                break;
+            } else if (errno == EINTR) {
+                continue;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            } else {
+                fail_connection(index, std::string("Connection lost: ") + strerror(errno));
+                return;
+            }
+        }
+
+        if (!options_.framed) {
+            // Legacy protocol: the reply is complete once the server closes
+            if (!eof) return;
+            uint64_t request_id = conn.legacy_request_id;
+            bool parsed = reply.ParseFromString(conn.in);
+            close_connection(conn);
+            if (parsed) {
+                finish(request_id, reply);
+            } else {
+                finish(request_id, failure("Failed to parse server response"));
+            }
+            return;
+        }
+
+        size_t offset = 0;
+        const char* payload;
+        size_t len;
+        int status;
+        while ((status = next_frame(conn.in, offset, payload, len)) > 0) {
+            if (!reply.ParseFromArray(payload, static_cast<int>(len))) {
+                status = -1;
+                break;
+            }
+            offset += FRAME_HEADER_SIZE + len;
+            finish(reply.request_id(), reply);
+        }
+        conn.in.erase(0, offset);
+        if (status < 0) {
+            fail_connection(index, "Failed to parse server response");
+        } else if (eof) {
+            fail_connection(index, "Connection closed by server");
+        }
+    }
+
+    // Function to hand waiting requests to connections with a free slot
+    void dispatch() {
+        while (!backlog_.empty()) {
+            auto it = pending_.find(backlog_.front());
+            if (it == pending_.end()) {  // Timed out while waiting
+                backlog_.pop_front();
+                continue;
+            }
+            int index = free_connection();
+            if (index < 0) return;
+            Connection& conn = connections_[index];
+            if (conn.fd < 0 && !open_connection(conn)) {
+                backlog_.pop_front();
+                finish(it->first, failure(std::string("Connection failed: ") + strerror(errno)));
+                continue;
+            }
+            conn.out += it->second.data;
+            it->second.data = std::string();
+            it->second.connection = index;
+            ++conn.in_flight;
+            if (!options_.framed) conn.legacy_request_id = it->first;
+            backlog_.pop_front();
+        }
+    }
+
+    // Round robin over connections with room for another request
+    int free_connection() {
+        for (size_t tried = 0; tried < connections_.size(); ++tried) {
+            size_t index = next_connection_++ % connections_.size();
+            if (connections_[index].in_flight < options_.window) return static_cast<int>(index);
+        }
+        return -1;
+    }
+
+    bool open_connection(Connection& conn) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (fd < 0) return false;
+        int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+        if (connect(fd, (const struct sockaddr*)&address_, sizeof(address_)) < 0 && errno != EINPROGRESS) {
+            int error = errno;
+            close(fd);
+            errno = error;
+            return false;
+        }
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = &conn;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            int error = errno;
+            close(fd);
+            errno = error;
+            return false;
+        }
+        conn.fd = fd;
+        conn.connected = false;
+        return true;
+    }
+
+    // Function to write as much pending output as the socket accepts
+    static bool flush(Connection& conn) {
+        while (conn.out_offset < conn.out.size()) {
+            ssize_t n = ::send(conn.fd, conn.out.data() + conn.out_offset, conn.out.size() - conn.out_offset, MSG_NOSIGNAL);
+            if (n > 0) {
+                conn.out_offset += n;
+            } else if (n < 0 && errno == EINTR) {
+                continue;
+            } else {
+                return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+            }
+        }
+        conn.out.clear();
+        conn.out_offset = 0;
+        return true;
+    }
+
+    static void close_connection(Connection& conn) {
+        if (conn.fd >= 0) close(conn.fd);  // Also removes it from the epoll set
+        conn.fd = -1;
+        conn.connected = false;
+        conn.out.clear();
+        conn.out_offset = 0;
+        conn.in.clear();
+        conn.in_flight = 0;
+        conn.legacy_request_id = 0;
+    }
+
+    // Function to drop a connection and fail every request sent on it. The
+    // next request for this slot opens a new connection.
+    void fail_connection(int index, const std::string& reason) {
+        close_connection(connections_[index]);
+        std::vector<uint64_t> lost;
+        for (auto& entry : pending_) {
+            if (entry.second.connection == index) {
+                entry.second.connection = -1;  // Its slot was freed with the connection
+                lost.push_back(entry.first);
+            }
+        }
+        for (uint64_t request_id : lost) finish(request_id, failure(reason));
+    }
+
+    // Function to fail requests whose deadline has passed
+    void expire(uint64_t now) {
+        while (!deadlines_.empty() && deadlines_.front().deadline_ns <= now) {
+            uint64_t request_id = deadlines_.front().request_id;
+            deadlines_.pop_front();
+            auto it = pending_.find(request_id);
+            if (it == pending_.end()) continue;  // Already answered
+            int index = it->second.connection;
+            if (index >= 0 && !connections_[index].connected) {
+                // Still connecting after a full timeout: the server is unreachable
+                fail_connection(index, "Connection timed out");
+                continue;
+            }
+            if (index >= 0 && !options_.framed) close_connection(connections_[index]);
+            finish(request_id, failure("Request timed out"));  // A late reply is ignored
+        }
+    }
+
+    static ControlReply failure(const std::string& reason) {
+        ControlReply reply;
+        reply.message = reason;
+        return reply;
+    }
+
+    void finish(uint64_t request_id, const ServerMessage& message) {
+        ControlReply reply;
+        if (message.has_reg_ack()) {
+            reply.status = message.reg_ack().status();
+            reply.message = message.reg_ack().status_message();
+        } else if (message.has_pdu_ack()) {
+            reply.status = message.pdu_ack().status();
+            reply.pdu_id = message.pdu_ack().pdu_id();
+            reply.message = message.pdu_ack().status_message();
+        } else if (message.has_dereg_ack()) {
+            reply.status = message.dereg_ack().status();
+            reply.message = message.dereg_ack().status_message();
+        } else {
+            reply.message = "Unexpected response type";
+        }
+        finish(request_id, reply);
+    }
+
+    void finish(uint64_t request_id, const ControlReply& reply) {
+        auto it = pending_.find(request_id);
+        if (it == pending_.end()) return;  // Timed out earlier
+        Pending pending = std::move(it->second);
+        pending_.erase(it);
+        if (pending.connection >= 0 && options_.framed) --connections_[pending.connection].in_flight;
+        complete(pending, reply);
+    }
+
+    void complete(Pending& pending, const ControlReply& reply) {
+        outstanding_.fetch_sub(1, std::memory_order_relaxed);
+        if (pending.callback) pending.callback(reply);
+    }
+
+    struct Deadline {
+        uint64_t deadline_ns;
+        uint64_t request_id;
+    };
+
+    ControlClientOptions options_;
+    struct sockaddr_in address_;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> next_request_id_{1};
+    std::atomic<size_t> outstanding_{0};
+
+    std::mutex incoming_mutex_;           // Guards incoming_
+    std::vector<Submission> incoming_;    // Submitted, not yet seen by the I/O thread
+
+    // Owned by the I/O thread
+    std::vector<Connection> connections_;
+    size_t next_connection_ = 0;
+    std::unordered_map<uint64_t, Pending> pending_;   // request_id -> request
+    std::deque<uint64_t> backlog_;                    // Waiting for a free slot, in order
+    std::deque<Deadline> deadlines_;                  // In submission order, so sorted
+    std::thread io_thread_;
+};
+
+#endif // CONTROL_CLIENT_H
@@ -0,0 +1,61 @@
+// Length-prefixed framing for persistent connections: every ClientMessage /
+// ServerMessage is preceded by its size as a 4-byte big-endian integer.
+#ifndef FRAMING_H
+#define FRAMING_H
+
+#include <cstdint>
+#include <string>
+#include <google/protobuf/message_lite.h>
+
+#define FRAME_HEADER_SIZE 4
+#define MAX_FRAME_SIZE (4 * 1024 * 1024)   // Larger frames are treated as a protocol error
+
+inline void put_frame_length(char* header, uint32_t len) {
+    header[0] = static_cast<char>(len >> 24);
+    header[1] = static_cast<char>(len >> 16);
+    header[2] = static_cast<char>(len >> 8);
+    header[3] = static_cast<char>(len);
+}
+
+inline uint32_t get_frame_length(const char* header) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(header);
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+// Reserves a frame header in 'out' and returns its offset; pair with end_frame()
+// once the payload has been appended.
+inline size_t begin_frame(std::string& out) {
+    size_t header = out.size();
+    out.append(FRAME_HEADER_SIZE, '\0');
+    return header;
+}
+
+inline void end_frame(std::string& out, size_t header) {
+    put_frame_length(&out[header], static_cast<uint32_t>(out.size() - header - FRAME_HEADER_SIZE));
+}
+
+// Appends 'msg' to 'out' as one frame
+inline bool append_frame(const google::protobuf::MessageLite& msg, std::string& out) {
+    size_t header = begin_frame(out);
+    if (!msg.AppendToString(&out)) {
+        out.resize(header);
+        return false;
+    }
+    end_frame(out, header);
+    return true;
+}
+
+// Looks for a complete frame at 'offset' in 'buffer'. Returns 1 and sets
+// 'payload'/'len' if one is available, 0 if more bytes are needed and -1 if
+// the frame is oversized.
+inline int next_frame(const std::string& buffer, size_t offset, const char*& payload, size_t& len) {
+    if (buffer.size() - offset < FRAME_HEADER_SIZE) return 0;
+    uint32_t frame_len = get_frame_length(buffer.data() + offset);
+    if (frame_len > MAX_FRAME_SIZE) return -1;
+    if (buffer.size() - offset - FRAME_HEADER_SIZE < frame_len) return 0;
+    payload = buffer.data() + offset + FRAME_HEADER_SIZE;
+    len = frame_len;
+    return 1;
+}
+
+#endif // FRAMING_H
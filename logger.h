@@ -0,0 +1,287 @@
+// Asynchronous logger for request threads. Each thread that logs gets its
+// own single-producer/single-consumer ring of fixed-size binary records; a
+// background writer thread drains every ring, formats the records and writes
+// them out in batches. Logging a record is a level check, a clock read and a
+// copy into the ring. It never locks, allocates or blocks: if a ring is full,
+// the record is dropped and counted.
+//
+//   LOG_INFO("User Registered: {}", id);
+//   LOG_DEBUG("Raw request body: {}", body);
+//
+// Each "{}" in the format (which must be a string literal) is replaced by
+// the next argument. A record holds up to LOG_MAX_ARGS integer arguments and
+// one string argument; the string is truncated to LOG_TEXT_SIZE bytes.
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <unistd.h>
+
+#define LOG_RING_SIZE 4096       // Records per thread ring (power of two)
+#define LOG_MAX_ARGS 4           // Integer arguments per record
+#define LOG_TEXT_SIZE 72         // Bytes of string argument per record
+#define LOG_WRITE_BUFFER 65536   // Formatted bytes per write() by the writer thread
+#define LOG_IDLE_SLEEP_US 1000   // Writer poll interval while all rings are empty
+
+enum LogLevel {
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_OFF
+};
+
+// Current level; records below it are skipped before any work is done.
+// Constant-initialized and lock-free, so it may be changed from a signal handler.
+inline std::atomic<int>& log_level() {
+    static std::atomic<int> level(LOG_LEVEL_INFO);
+    return level;
+}
+
+inline bool log_enabled(LogLevel level) {
+    return level >= log_level().load(std::memory_order_relaxed);
+}
+
+// Function to parse a level name ("debug", "info", "warn", "error", "off").
+// Returns false for an unknown name.
+inline bool parse_log_level(const std::string& name, LogLevel& level) {
+    static const char* const names[] = {"debug", "info", "warn", "error", "off"};
+    for (int i = LOG_LEVEL_DEBUG; i <= LOG_LEVEL_OFF; ++i) {
+        if (name == names[i]) {
+            level = static_cast<LogLevel>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function to change the log level at runtime: SIGUSR1 logs more, SIGUSR2 less
+inline void adjust_log_level(int signal) {
+    int level = log_level().load(std::memory_order_relaxed);
+    if (signal == SIGUSR1 && level > LOG_LEVEL_DEBUG) --level;
+    if (signal == SIGUSR2 && level < LOG_LEVEL_OFF) ++level;
+    log_level().store(level, std::memory_order_relaxed);
+}
+
+// One log record, one cache-line pair. Formatting happens on the writer thread.
+struct LogRecord {
+    uint64_t time_ns;          // CLOCK_REALTIME
+    const char* format;        // String literal
+    uint8_t level;
+    uint8_t argc;              // Integer arguments used
+    uint8_t text_arg;          // Position of the string argument, or 0xff
+    uint8_t text_len;
+    uint32_t thread;           // Index of the logging thread
+    int64_t args[LOG_MAX_ARGS];
+    char text[LOG_TEXT_SIZE];
+};
+static_assert(sizeof(LogRecord) == 128, "log record must stay two cache lines");
+
+class Logger {
+public:
+    static Logger& instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // Drains every ring before returning, so records logged before exit are kept
+    ~Logger() {
+        stop_.store(true, std::memory_order_release);
+        if (writer_.joinable()) writer_.join();
+    }
+
+    template <typename... Args>
+    void log(LogLevel level, const char* format, const Args&... args) {
+        Ring* ring = thread_ring();
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        if (tail - ring->head.load(std::memory_order_acquire) >= LOG_RING_SIZE) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        LogRecord& record = ring->records[tail & (LOG_RING_SIZE - 1)];
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        record.time_ns = uint64_t(now.tv_sec) * 1000000000ull + uint64_t(now.tv_nsec);
+        record.format = format;
+        record.level = static_cast<uint8_t>(level);
+        record.argc = 0;
+        record.text_arg = 0xff;
+        record.text_len = 0;
+        record.thread = ring->thread;
+        int expand[] = {0, (add_arg(record, args), 0)...};
+        (void)expand;
+        ring->tail.store(tail + 1, std::memory_order_release);
+    }
+
+    // Records dropped because a ring was full
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Ring {
+        // head and tail are kept on separate cache lines
+        std::atomic<uint64_t> head{0};   // Next record for the writer
+        char head_pad[56];
+        std::atomic<uint64_t> tail{0};   // Next free slot for the producer
+        char tail_pad[56];
+        std::atomic<bool> retired{false};           // Producer thread has exited
+        uint32_t thread = 0;
+        LogRecord records[LOG_RING_SIZE];
+    };
+
+    // Marks the calling thread's ring as retired when the thread exits; the
+    // writer frees it once drained
+    struct RingOwner {
+        Ring* ring = nullptr;
+        ~RingOwner() {
+            if (ring != nullptr) ring->retired.store(true, std::memory_order_release);
+        }
+    };
+
+    Logger() : writer_(&Logger::write_loop, this) {}
+
+    Ring* thread_ring() {
+        static thread_local RingOwner owner;
+        if (owner.ring == nullptr) {
+            std::unique_ptr<Ring> ring(new Ring());
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            ring->thread = next_thread_++;
+            owner.ring = ring.get();
+            rings_.push_back(std::move(ring));
+        }
+        return owner.ring;
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+    add_arg(LogRecord& record, const T& value) {
+        if (record.argc < LOG_MAX_ARGS) record.args[record.argc++] = static_cast<int64_t>(value);
+    }
+
+    static void add_arg(LogRecord& record, const char* text) { add_text(record, text, std::strlen(text)); }
+    static void add_arg(LogRecord& record, const std::string& text) { add_text(record, text.data(), text.size()); }
+
+    static void add_text(LogRecord& record, const char* text, size_t len) {
+        if (record.text_arg != 0xff) return;  // Only one string per record
+        record.text_arg = record.argc;
+        record.text_len = static_cast<uint8_t>(len < LOG_TEXT_SIZE ? len : LOG_TEXT_SIZE);
+        std::memcpy(record.text, text, record.text_len);
+    }
+
+    void write_loop() {
+        std::string out;
+        out.reserve(LOG_WRITE_BUFFER * 2);
+        uint64_t reported_drops = 0;
+        while (true) {
+            bool stopping = stop_.load(std::memory_order_acquire);
+            size_t drained = drain_rings(out);
+
+            uint64_t drops = dropped();
+            if (drops != reported_drops) {
+                out += "[logger] " + std::to_string(drops - reported_drops) + " records dropped\n";
+                reported_drops = drops;
+            }
+            flush(out);
+
+            if (stopping) break;
+            if (drained == 0) std::this_thread::sleep_for(std::chrono::microseconds(LOG_IDLE_SLEEP_US));
+        }
+    }
+
+    size_t drain_rings(std::string& out) {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        size_t drained = 0;
+        for (size_t i = 0; i < rings_.size();) {
+            Ring& ring = *rings_[i];
+            bool retired = ring.retired.load(std::memory_order_acquire);
+            uint64_t head = ring.head.load(std::memory_order_relaxed);
+            uint64_t tail = ring.tail.load(std::memory_order_acquire);
+            for (; head != tail; ++head, ++drained) {
+                format_record(ring.records[head & (LOG_RING_SIZE - 1)], out);
+                if (out.size() >= LOG_WRITE_BUFFER) flush(out);
+                // Free the slot as soon as it is formatted
+                ring.head.store(head + 1, std::memory_order_release);
+            }
+            if (retired) {
+                rings_.erase(rings_.begin() + i);  // Producer is gone and its ring is empty
+            } else {
+                ++i;
+            }
+        }
+        return drained;
+    }
+
+    static void format_record(const LogRecord& record, std::string& out) {
+        static const char* const level_names[] = {"DEBUG", "INFO ", "WARN ", "ERROR"};
+        char prefix[64];
+        time_t seconds = static_cast<time_t>(record.time_ns / 1000000000ull);
+        struct tm local;
+        localtime_r(&seconds, &local);
+        size_t len = strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S", &local);
+        len += snprintf(prefix + len, sizeof(prefix) - len, ".%06u %s [%u] ",
+                        unsigned(record.time_ns % 1000000000ull / 1000), level_names[record.level],
+                        record.thread);
+        out.append(prefix, len);
+
+        // Substitute "{}" placeholders; the string argument sits at position
+        // text_arg among the integers
+        unsigned next_int = 0;
+        unsigned position = 0;
+        for (const char* p = record.format; *p != '\0'; ++p) {
+            if (p[0] == '{' && p[1] == '}') {
+                if (position == record.text_arg && record.text_arg != 0xff) {
+                    out.append(record.text, record.text_len);
+                } else if (next_int < record.argc) {
+                    out += std::to_string(record.args[next_int++]);
+                }
+                ++position;
+                ++p;
+            } else {
+                out += *p;
+            }
+        }
+        out += '\n';
+    }
+
+    static void flush(std::string& out) {
+        size_t written = 0;
+        while (written < out.size()) {
+            ssize_t n = write(STDOUT_FILENO, out.data() + written, out.size() - written);
+            if (n < 0) break;  // Nowhere to report it; drop the batch
+            written += static_cast<size_t>(n);
+        }
+        out.clear();
+    }
+
+    std::mutex rings_mutex_;          // Guards rings_; taken once per new thread and by the writer
+    std::vector<std::unique_ptr<Ring>> rings_;
+    uint32_t next_thread_ = 0;
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> stop_{false};
+    std::thread writer_;              // Declared last: started once the members above exist
+};
+
+#define LOG_AT(level, ...) \
+    do { if (log_enabled(level)) Logger::instance().log(level, __VA_ARGS__); } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)  LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_WARN(...)  LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+
+#endif // LOGGER_H
@@ -108,9 +108,36 @@ struct DeregistrationAckDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 DeregistrationAckDefaultTypeInternal _DeregistrationAck_default_instance_;
+PROTOBUF_CONSTEXPR ClientBatch::ClientBatch(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.messages_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct ClientBatchDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR ClientBatchDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~ClientBatchDefaultTypeInternal() {}
+  union {
+    ClientBatch _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 ClientBatchDefaultTypeInternal _ClientBatch_default_instance_;
+PROTOBUF_CONSTEXPR ServerBatch::ServerBatch(
+    ::_pbi::ConstantInitialized): _impl_{
+    /*decltype(_impl_.messages_)*/{}
+  , /*decltype(_impl_._cached_size_)*/{}} {}
+struct ServerBatchDefaultTypeInternal {
+  PROTOBUF_CONSTEXPR ServerBatchDefaultTypeInternal()
+      : _instance(::_pbi::ConstantInitialized{}) {}
+  ~ServerBatchDefaultTypeInternal() {}
+  union {
+    ServerBatch _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 ServerBatchDefaultTypeInternal _ServerBatch_default_instance_;
 PROTOBUF_CONSTEXPR ClientMessage::ClientMessage(
     ::_pbi::ConstantInitialized): _impl_{
-    /*decltype(_impl_.type_)*/0
+    /*decltype(_impl_.request_id_)*/uint64_t{0u}
+  , /*decltype(_impl_.type_)*/0
   , /*decltype(_impl_.payload_)*/{}
   , /*decltype(_impl_._cached_size_)*/{}
   , /*decltype(_impl_._oneof_case_)*/{}} {}
@@ -125,7 +152,8 @@ struct ClientMessageDefaultTypeInternal {
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 ClientMessageDefaultTypeInternal _ClientMessage_default_instance_;
 PROTOBUF_CONSTEXPR ServerMessage::ServerMessage(
     ::_pbi::ConstantInitialized): _impl_{
-    /*decltype(_impl_.type_)*/0
+    /*decltype(_impl_.request_id_)*/uint64_t{0u}
+  , /*decltype(_impl_.type_)*/0
   , /*decltype(_impl_.payload_)*/{}
   , /*decltype(_impl_._cached_size_)*/{}
   , /*decltype(_impl_._oneof_case_)*/{}} {}
@@ -138,7 +166,7 @@ struct ServerMessageDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PROTOBUF_ATTRIBUTE_INIT_PRIORITY1 ServerMessageDefaultTypeInternal _ServerMessage_default_instance_;
-static ::_pb::Metadata file_level_metadata_message_2eproto[8];
+static ::_pb::Metadata file_level_metadata_message_2eproto[10];
 static const ::_pb::EnumDescriptor* file_level_enum_descriptors_message_2eproto[1];
 static constexpr ::_pb::ServiceDescriptor const** file_level_service_descriptors_message_2eproto = nullptr;
 
@@ -196,6 +224,20 @@ const uint32_t TableStruct_message_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(
   PROTOBUF_FIELD_OFFSET(::DeregistrationAck, _impl_.status_),
   PROTOBUF_FIELD_OFFSET(::DeregistrationAck, _impl_.status_message_),
   ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::ClientBatch, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::ClientBatch, _impl_.messages_),
+  ~0u,  // no _has_bits_
+  PROTOBUF_FIELD_OFFSET(::ServerBatch, _internal_metadata_),
+  ~0u,  // no _extensions_
+  ~0u,  // no _oneof_case_
+  ~0u,  // no _weak_field_map_
+  ~0u,  // no _inlined_string_donated_
+  PROTOBUF_FIELD_OFFSET(::ServerBatch, _impl_.messages_),
+  ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::ClientMessage, _internal_metadata_),
   ~0u,  // no _extensions_
   PROTOBUF_FIELD_OFFSET(::ClientMessage, _impl_._oneof_case_[0]),
@@ -205,6 +247,8 @@ const uint32_t TableStruct_message_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(
   ::_pbi::kInvalidFieldOffsetTag,
   ::_pbi::kInvalidFieldOffsetTag,
   ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  PROTOBUF_FIELD_OFFSET(::ClientMessage, _impl_.request_id_),
   PROTOBUF_FIELD_OFFSET(::ClientMessage, _impl_.payload_),
   ~0u,  // no _has_bits_
   PROTOBUF_FIELD_OFFSET(::ServerMessage, _internal_metadata_),
@@ -216,6 +260,8 @@ const uint32_t TableStruct_message_2eproto::offsets[] PROTOBUF_SECTION_VARIABLE(
   ::_pbi::kInvalidFieldOffsetTag,
   ::_pbi::kInvalidFieldOffsetTag,
   ::_pbi::kInvalidFieldOffsetTag,
+  ::_pbi::kInvalidFieldOffsetTag,
+  PROTOBUF_FIELD_OFFSET(::ServerMessage, _impl_.request_id_),
   PROTOBUF_FIELD_OFFSET(::ServerMessage, _impl_.payload_),
 };
 static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protodesc_cold) = {
@@ -225,8 +271,10 @@ static const ::_pbi::MigrationSchema schemas[] PROTOBUF_SECTION_VARIABLE(protode
   { 26, -1, -1, sizeof(::PduSessionAck)},
   { 36, -1, -1, sizeof(::DeregistrationRequest)},
   { 43, -1, -1, sizeof(::DeregistrationAck)},
-  { 52, -1, -1, sizeof(::ClientMessage)},
-  { 63, -1, -1, sizeof(::ServerMessage)},
+  { 52, -1, -1, sizeof(::ClientBatch)},
+  { 59, -1, -1, sizeof(::ServerBatch)},
+  { 66, -1, -1, sizeof(::ClientMessage)},
+  { 79, -1, -1, sizeof(::ServerMessage)},
 };
 
 static const ::_pb::Message* const file_default_instances[] = {
@@ -236,6 +284,8 @@ static const ::_pb::Message* const file_default_instances[] = {
   &::_PduSessionAck_default_instance_._instance,
   &::_DeregistrationRequest_default_instance_._instance,
   &::_DeregistrationAck_default_instance_._instance,
+  &::_ClientBatch_default_instance_._instance,
+  &::_ServerBatch_default_instance_._instance,
   &::_ClientMessage_default_instance_._instance,
   &::_ServerMessage_default_instance_._instance,
 };
@@ -250,26 +300,32 @@ const char descriptor_table_protodef_message_2eproto[] PROTOBUF_SECTION_VARIABLE
   "\022\016\n\006status\030\003 \001(\005\022\026\n\016status_message\030\004 \001(\t"
   "\"#\n\025DeregistrationRequest\022\n\n\002id\030\001 \001(\005\"G\n"
   "\021DeregistrationAck\022\n\n\002id\030\001 \001(\005\022\016\n\006status"
-  "\030\002 \001(\005\022\026\n\016status_message\030\003 \001(\t\"\263\001\n\rClien"
-  "tMessage\022\032\n\004type\030\001 \001(\0162\014.MessageType\022\'\n\007"
-  "reg_req\030\002 \001(\0132\024.RegistrationRequestH\000\022%\n"
-  "\007pdu_req\030\003 \001(\0132\022.PduSessionRequestH\000\022+\n\t"
-  "dereg_req\030\004 \001(\0132\026.DeregistrationRequestH"
-  "\000B\t\n\007payload\"\247\001\n\rServerMessage\022\032\n\004type\030\001"
-  " \001(\0162\014.MessageType\022#\n\007reg_ack\030\002 \001(\0132\020.Re"
-  "gistrationAckH\000\022!\n\007pdu_ack\030\003 \001(\0132\016.PduSe"
-  "ssionAckH\000\022\'\n\tdereg_ack\030\004 \001(\0132\022.Deregist"
-  "rationAckH\000B\t\n\007payload*\237\001\n\013MessageType\022\030"
+  "\030\002 \001(\005\022\026\n\016status_message\030\003 \001(\t\"/\n\013Client"
+  "Batch\022 \n\010messages\030\001 \003(\0132\016.ClientMessage\""
+  "/\n\013ServerBatch\022 \n\010messages\030\001 \003(\0132\016.Serve"
+  "rMessage\"\346\001\n\rClientMessage\022\032\n\004type\030\001 \001(\016"
+  "2\014.MessageType\022\'\n\007reg_req\030\002 \001(\0132\024.Regist"
+  "rationRequestH\000\022%\n\007pdu_req\030\003 \001(\0132\022.PduSe"
+  "ssionRequestH\000\022+\n\tdereg_req\030\004 \001(\0132\026.Dere"
+  "gistrationRequestH\000\022\035\n\005batch\030\006 \001(\0132\014.Cli"
+  "entBatchH\000\022\022\n\nrequest_id\030\005 \001(\004B\t\n\007payloa"
+  "d\"\332\001\n\rServerMessage\022\032\n\004type\030\001 \001(\0162\014.Mess"
+  "ageType\022#\n\007reg_ack\030\002 \001(\0132\020.RegistrationA"
+  "ckH\000\022!\n\007pdu_ack\030\003 \001(\0132\016.PduSessionAckH\000\022"
+  "\'\n\tdereg_ack\030\004 \001(\0132\022.DeregistrationAckH\000"
+  "\022\035\n\005batch\030\006 \001(\0132\014.ServerBatchH\000\022\022\n\nreque"
+  "st_id\030\005 \001(\004B\t\n\007payload*\301\001\n\013MessageType\022\030"
   "\n\024REGISTRATION_REQUEST\020\000\022\024\n\020REGISTRATION"
   "_ACK\020\001\022\027\n\023PDU_SESSION_REQUEST\020\002\022\023\n\017PDU_S"
   "ESSION_ACK\020\003\022\032\n\026DEREGISTRATION_REQUEST\020\004"
-  "\022\026\n\022DEREGISTRATION_ACK\020\005b\006proto3"
+  "\022\026\n\022DEREGISTRATION_ACK\020\005\022\021\n\rBATCH_REQUES"
+  "T\020\006\022\r\n\tBATCH_ACK\020\007B\005H\001\370\001\001b\006proto3"
   ;
 static ::_pbi::once_flag descriptor_table_message_2eproto_once;
 const ::_pbi::DescriptorTable descriptor_table_message_2eproto = {
-    false, false, 912, descriptor_table_protodef_message_2eproto,
+    false, false, 1153, descriptor_table_protodef_message_2eproto,
     "message.proto",
-    &descriptor_table_message_2eproto_once, nullptr, 0, 8,
+    &descriptor_table_message_2eproto_once, nullptr, 0, 10,
     schemas, file_default_instances, TableStruct_message_2eproto::offsets,
     file_level_metadata_message_2eproto, file_level_enum_descriptors_message_2eproto,
     file_level_service_descriptors_message_2eproto,
@@ -292,6 +348,8 @@ bool MessageType_IsValid(int value) {
     case 3:
     case 4:
     case 5:
+    case 6:
+    case 7:
       return true;
     default:
       return false;
@@ -1757,11 +1815,382 @@ void DeregistrationAck::InternalSwap(DeregistrationAck* other) {
 
 // ===================================================================
 
+class ClientBatch::_Internal {
+ public:
+};
+
+ClientBatch::ClientBatch(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:ClientBatch)
+}
+ClientBatch::ClientBatch(const ClientBatch& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  ClientBatch* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.messages_){from._impl_.messages_}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  // @@protoc_insertion_point(copy_constructor:ClientBatch)
+}
+
+inline void ClientBatch::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.messages_){arena}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+ClientBatch::~ClientBatch() {
+  // @@protoc_insertion_point(destructor:ClientBatch)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void ClientBatch::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.messages_.~RepeatedPtrField();
+}
+
+void ClientBatch::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void ClientBatch::Clear() {
+// @@protoc_insertion_point(message_clear_start:ClientBatch)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.messages_.Clear();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* ClientBatch::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // repeated .ClientMessage messages = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_messages(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<10>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* ClientBatch::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:ClientBatch)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // repeated .ClientMessage messages = 1;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_messages_size()); i < n; i++) {
+    const auto& repfield = this->_internal_messages(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(1, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:ClientBatch)
+  return target;
+}
+
+size_t ClientBatch::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:ClientBatch)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated .ClientMessage messages = 1;
+  total_size += 1UL * this->_internal_messages_size();
+  for (const auto& msg : this->_impl_.messages_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData ClientBatch::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    ClientBatch::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*ClientBatch::GetClassData() const { return &_class_data_; }
+
+
+void ClientBatch::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<ClientBatch*>(&to_msg);
+  auto& from = static_cast<const ClientBatch&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:ClientBatch)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.messages_.MergeFrom(from._impl_.messages_);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void ClientBatch::CopyFrom(const ClientBatch& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:ClientBatch)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool ClientBatch::IsInitialized() const {
+  return true;
+}
+
+void ClientBatch::InternalSwap(ClientBatch* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.messages_.InternalSwap(&other->_impl_.messages_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata ClientBatch::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_message_2eproto_getter, &descriptor_table_message_2eproto_once,
+      file_level_metadata_message_2eproto[6]);
+}
+
+// ===================================================================
+
+class ServerBatch::_Internal {
+ public:
+};
+
+ServerBatch::ServerBatch(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
+  SharedCtor(arena, is_message_owned);
+  // @@protoc_insertion_point(arena_constructor:ServerBatch)
+}
+ServerBatch::ServerBatch(const ServerBatch& from)
+  : ::PROTOBUF_NAMESPACE_ID::Message() {
+  ServerBatch* const _this = this; (void)_this;
+  new (&_impl_) Impl_{
+      decltype(_impl_.messages_){from._impl_.messages_}
+    , /*decltype(_impl_._cached_size_)*/{}};
+
+  _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+  // @@protoc_insertion_point(copy_constructor:ServerBatch)
+}
+
+inline void ServerBatch::SharedCtor(
+    ::_pb::Arena* arena, bool is_message_owned) {
+  (void)arena;
+  (void)is_message_owned;
+  new (&_impl_) Impl_{
+      decltype(_impl_.messages_){arena}
+    , /*decltype(_impl_._cached_size_)*/{}
+  };
+}
+
+ServerBatch::~ServerBatch() {
+  // @@protoc_insertion_point(destructor:ServerBatch)
+  if (auto *arena = _internal_metadata_.DeleteReturnArena<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>()) {
+  (void)arena;
+    return;
+  }
+  SharedDtor();
+}
+
+inline void ServerBatch::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  _impl_.messages_.~RepeatedPtrField();
+}
+
+void ServerBatch::SetCachedSize(int size) const {
+  _impl_._cached_size_.Set(size);
+}
+
+void ServerBatch::Clear() {
+// @@protoc_insertion_point(message_clear_start:ServerBatch)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  _impl_.messages_.Clear();
+  _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
+}
+
+const char* ServerBatch::_InternalParse(const char* ptr, ::_pbi::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::_pbi::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // repeated .ServerMessage messages = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_messages(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<10>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* ServerBatch::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:ServerBatch)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  // repeated .ServerMessage messages = 1;
+  for (unsigned i = 0,
+      n = static_cast<unsigned>(this->_internal_messages_size()); i < n; i++) {
+    const auto& repfield = this->_internal_messages(i);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+        InternalWriteMessage(1, repfield, repfield.GetCachedSize(), target, stream);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
+        _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:ServerBatch)
+  return target;
+}
+
+size_t ServerBatch::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:ServerBatch)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  // repeated .ServerMessage messages = 1;
+  total_size += 1UL * this->_internal_messages_size();
+  for (const auto& msg : this->_impl_.messages_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
+  return MaybeComputeUnknownFieldsSize(total_size, &_impl_._cached_size_);
+}
+
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData ServerBatch::_class_data_ = {
+    ::PROTOBUF_NAMESPACE_ID::Message::CopyWithSourceCheck,
+    ServerBatch::MergeImpl
+};
+const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*ServerBatch::GetClassData() const { return &_class_data_; }
+
+
+void ServerBatch::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg) {
+  auto* const _this = static_cast<ServerBatch*>(&to_msg);
+  auto& from = static_cast<const ServerBatch&>(from_msg);
+  // @@protoc_insertion_point(class_specific_merge_from_start:ServerBatch)
+  GOOGLE_DCHECK_NE(&from, _this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  _this->_impl_.messages_.MergeFrom(from._impl_.messages_);
+  _this->_internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
+}
+
+void ServerBatch::CopyFrom(const ServerBatch& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:ServerBatch)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool ServerBatch::IsInitialized() const {
+  return true;
+}
+
+void ServerBatch::InternalSwap(ServerBatch* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  _impl_.messages_.InternalSwap(&other->_impl_.messages_);
+}
+
+::PROTOBUF_NAMESPACE_ID::Metadata ServerBatch::GetMetadata() const {
+  return ::_pbi::AssignDescriptors(
+      &descriptor_table_message_2eproto_getter, &descriptor_table_message_2eproto_once,
+      file_level_metadata_message_2eproto[7]);
+}
+
+// ===================================================================
+
 class ClientMessage::_Internal {
  public:
   static const ::RegistrationRequest& reg_req(const ClientMessage* msg);
   static const ::PduSessionRequest& pdu_req(const ClientMessage* msg);
   static const ::DeregistrationRequest& dereg_req(const ClientMessage* msg);
+  static const ::ClientBatch& batch(const ClientMessage* msg);
 };
 
 const ::RegistrationRequest&
@@ -1776,6 +2205,10 @@ const ::DeregistrationRequest&
 ClientMessage::_Internal::dereg_req(const ClientMessage* msg) {
   return *msg->_impl_.payload_.dereg_req_;
 }
+const ::ClientBatch&
+ClientMessage::_Internal::batch(const ClientMessage* msg) {
+  return *msg->_impl_.payload_.batch_;
+}
 void ClientMessage::set_allocated_reg_req(::RegistrationRequest* reg_req) {
   ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
   clear_payload();
@@ -1821,6 +2254,21 @@ void ClientMessage::set_allocated_dereg_req(::DeregistrationRequest* dereg_req)
   }
   // @@protoc_insertion_point(field_set_allocated:ClientMessage.dereg_req)
 }
+void ClientMessage::set_allocated_batch(::ClientBatch* batch) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_payload();
+  if (batch) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(batch);
+    if (message_arena != submessage_arena) {
+      batch = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, batch, submessage_arena);
+    }
+    set_has_batch();
+    _impl_.payload_.batch_ = batch;
+  }
+  // @@protoc_insertion_point(field_set_allocated:ClientMessage.batch)
+}
 ClientMessage::ClientMessage(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
@@ -1831,13 +2279,16 @@ ClientMessage::ClientMessage(const ClientMessage& from)
   : ::PROTOBUF_NAMESPACE_ID::Message() {
   ClientMessage* const _this = this; (void)_this;
   new (&_impl_) Impl_{
-      decltype(_impl_.type_){}
+      decltype(_impl_.request_id_){}
+    , decltype(_impl_.type_){}
     , decltype(_impl_.payload_){}
     , /*decltype(_impl_._cached_size_)*/{}
     , /*decltype(_impl_._oneof_case_)*/{}};
 
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
-  _this->_impl_.type_ = from._impl_.type_;
+  ::memcpy(&_impl_.request_id_, &from._impl_.request_id_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.type_) -
+    reinterpret_cast<char*>(&_impl_.request_id_)) + sizeof(_impl_.type_));
   clear_has_payload();
   switch (from.payload_case()) {
     case kRegReq: {
@@ -1855,6 +2306,11 @@ ClientMessage::ClientMessage(const ClientMessage& from)
           from._internal_dereg_req());
       break;
     }
+    case kBatch: {
+      _this->_internal_mutable_batch()->::ClientBatch::MergeFrom(
+          from._internal_batch());
+      break;
+    }
     case PAYLOAD_NOT_SET: {
       break;
     }
@@ -1867,7 +2323,8 @@ inline void ClientMessage::SharedCtor(
   (void)arena;
   (void)is_message_owned;
   new (&_impl_) Impl_{
-      decltype(_impl_.type_){0}
+      decltype(_impl_.request_id_){uint64_t{0u}}
+    , decltype(_impl_.type_){0}
     , decltype(_impl_.payload_){}
     , /*decltype(_impl_._cached_size_)*/{}
     , /*decltype(_impl_._oneof_case_)*/{}
@@ -1916,6 +2373,12 @@ void ClientMessage::clear_payload() {
       }
       break;
     }
+    case kBatch: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.payload_.batch_;
+      }
+      break;
+    }
     case PAYLOAD_NOT_SET: {
       break;
     }
@@ -1930,7 +2393,9 @@ void ClientMessage::Clear() {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  _impl_.type_ = 0;
+  ::memset(&_impl_.request_id_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.type_) -
+      reinterpret_cast<char*>(&_impl_.request_id_)) + sizeof(_impl_.type_));
   clear_payload();
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
@@ -1974,6 +2439,22 @@ const char* ClientMessage::_InternalParse(const char* ptr, ::_pbi::ParseContext*
         } else
           goto handle_unusual;
         continue;
+      // uint64 request_id = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          _impl_.request_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .ClientBatch batch = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 50)) {
+          ptr = ctx->ParseMessage(_internal_mutable_batch(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -2031,6 +2512,19 @@ uint8_t* ClientMessage::_InternalSerialize(
         _Internal::dereg_req(this).GetCachedSize(), target, stream);
   }
 
+  // uint64 request_id = 5;
+  if (this->_internal_request_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(5, this->_internal_request_id(), target);
+  }
+
+  // .ClientBatch batch = 6;
+  if (_internal_has_batch()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(6, _Internal::batch(this),
+        _Internal::batch(this).GetCachedSize(), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -2047,6 +2541,11 @@ size_t ClientMessage::ByteSizeLong() const {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
+  // uint64 request_id = 5;
+  if (this->_internal_request_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_request_id());
+  }
+
   // .MessageType type = 1;
   if (this->_internal_type() != 0) {
     total_size += 1 +
@@ -2075,6 +2574,13 @@ size_t ClientMessage::ByteSizeLong() const {
           *_impl_.payload_.dereg_req_);
       break;
     }
+    // .ClientBatch batch = 6;
+    case kBatch: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.payload_.batch_);
+      break;
+    }
     case PAYLOAD_NOT_SET: {
       break;
     }
@@ -2097,6 +2603,9 @@ void ClientMessage::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::
   uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
+  if (from._internal_request_id() != 0) {
+    _this->_internal_set_request_id(from._internal_request_id());
+  }
   if (from._internal_type() != 0) {
     _this->_internal_set_type(from._internal_type());
   }
@@ -2116,6 +2625,11 @@ void ClientMessage::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::
           from._internal_dereg_req());
       break;
     }
+    case kBatch: {
+      _this->_internal_mutable_batch()->::ClientBatch::MergeFrom(
+          from._internal_batch());
+      break;
+    }
     case PAYLOAD_NOT_SET: {
       break;
     }
@@ -2137,7 +2651,12 @@ bool ClientMessage::IsInitialized() const {
 void ClientMessage::InternalSwap(ClientMessage* other) {
   using std::swap;
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
-  swap(_impl_.type_, other->_impl_.type_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(ClientMessage, _impl_.type_)
+      + sizeof(ClientMessage::_impl_.type_)
+      - PROTOBUF_FIELD_OFFSET(ClientMessage, _impl_.request_id_)>(
+          reinterpret_cast<char*>(&_impl_.request_id_),
+          reinterpret_cast<char*>(&other->_impl_.request_id_));
   swap(_impl_.payload_, other->_impl_.payload_);
   swap(_impl_._oneof_case_[0], other->_impl_._oneof_case_[0]);
 }
@@ -2145,7 +2664,7 @@ void ClientMessage::InternalSwap(ClientMessage* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata ClientMessage::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_message_2eproto_getter, &descriptor_table_message_2eproto_once,
-      file_level_metadata_message_2eproto[6]);
+      file_level_metadata_message_2eproto[8]);
 }
 
 // ===================================================================
@@ -2155,6 +2674,7 @@ class ServerMessage::_Internal {
   static const ::RegistrationAck& reg_ack(const ServerMessage* msg);
   static const ::PduSessionAck& pdu_ack(const ServerMessage* msg);
   static const ::DeregistrationAck& dereg_ack(const ServerMessage* msg);
+  static const ::ServerBatch& batch(const ServerMessage* msg);
 };
 
 const ::RegistrationAck&
@@ -2169,6 +2689,10 @@ const ::DeregistrationAck&
 ServerMessage::_Internal::dereg_ack(const ServerMessage* msg) {
   return *msg->_impl_.payload_.dereg_ack_;
 }
+const ::ServerBatch&
+ServerMessage::_Internal::batch(const ServerMessage* msg) {
+  return *msg->_impl_.payload_.batch_;
+}
 void ServerMessage::set_allocated_reg_ack(::RegistrationAck* reg_ack) {
   ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
   clear_payload();
@@ -2214,6 +2738,21 @@ void ServerMessage::set_allocated_dereg_ack(::DeregistrationAck* dereg_ack) {
   }
   // @@protoc_insertion_point(field_set_allocated:ServerMessage.dereg_ack)
 }
+void ServerMessage::set_allocated_batch(::ServerBatch* batch) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  clear_payload();
+  if (batch) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+      ::PROTOBUF_NAMESPACE_ID::Arena::InternalGetOwningArena(batch);
+    if (message_arena != submessage_arena) {
+      batch = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, batch, submessage_arena);
+    }
+    set_has_batch();
+    _impl_.payload_.batch_ = batch;
+  }
+  // @@protoc_insertion_point(field_set_allocated:ServerMessage.batch)
+}
 ServerMessage::ServerMessage(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::Message(arena, is_message_owned) {
@@ -2224,13 +2763,16 @@ ServerMessage::ServerMessage(const ServerMessage& from)
   : ::PROTOBUF_NAMESPACE_ID::Message() {
   ServerMessage* const _this = this; (void)_this;
   new (&_impl_) Impl_{
-      decltype(_impl_.type_){}
+      decltype(_impl_.request_id_){}
+    , decltype(_impl_.type_){}
     , decltype(_impl_.payload_){}
     , /*decltype(_impl_._cached_size_)*/{}
     , /*decltype(_impl_._oneof_case_)*/{}};
 
   _internal_metadata_.MergeFrom<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(from._internal_metadata_);
-  _this->_impl_.type_ = from._impl_.type_;
+  ::memcpy(&_impl_.request_id_, &from._impl_.request_id_,
+    static_cast<size_t>(reinterpret_cast<char*>(&_impl_.type_) -
+    reinterpret_cast<char*>(&_impl_.request_id_)) + sizeof(_impl_.type_));
   clear_has_payload();
   switch (from.payload_case()) {
     case kRegAck: {
@@ -2248,6 +2790,11 @@ ServerMessage::ServerMessage(const ServerMessage& from)
           from._internal_dereg_ack());
       break;
     }
+    case kBatch: {
+      _this->_internal_mutable_batch()->::ServerBatch::MergeFrom(
+          from._internal_batch());
+      break;
+    }
     case PAYLOAD_NOT_SET: {
       break;
     }
@@ -2260,7 +2807,8 @@ inline void ServerMessage::SharedCtor(
   (void)arena;
   (void)is_message_owned;
   new (&_impl_) Impl_{
-      decltype(_impl_.type_){0}
+      decltype(_impl_.request_id_){uint64_t{0u}}
+    , decltype(_impl_.type_){0}
     , decltype(_impl_.payload_){}
     , /*decltype(_impl_._cached_size_)*/{}
     , /*decltype(_impl_._oneof_case_)*/{}
@@ -2309,6 +2857,12 @@ void ServerMessage::clear_payload() {
       }
       break;
     }
+    case kBatch: {
+      if (GetArenaForAllocation() == nullptr) {
+        delete _impl_.payload_.batch_;
+      }
+      break;
+    }
     case PAYLOAD_NOT_SET: {
       break;
     }
@@ -2323,7 +2877,9 @@ void ServerMessage::Clear() {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
-  _impl_.type_ = 0;
+  ::memset(&_impl_.request_id_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&_impl_.type_) -
+      reinterpret_cast<char*>(&_impl_.request_id_)) + sizeof(_impl_.type_));
   clear_payload();
   _internal_metadata_.Clear<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>();
 }
@@ -2367,6 +2923,22 @@ const char* ServerMessage::_InternalParse(const char* ptr, ::_pbi::ParseContext*
         } else
           goto handle_unusual;
         continue;
+      // uint64 request_id = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          _impl_.request_id_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // .ServerBatch batch = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 50)) {
+          ptr = ctx->ParseMessage(_internal_mutable_batch(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -2424,6 +2996,19 @@ uint8_t* ServerMessage::_InternalSerialize(
         _Internal::dereg_ack(this).GetCachedSize(), target, stream);
   }
 
+  // uint64 request_id = 5;
+  if (this->_internal_request_id() != 0) {
+    target = stream->EnsureSpace(target);
+    target = ::_pbi::WireFormatLite::WriteUInt64ToArray(5, this->_internal_request_id(), target);
+  }
+
+  // .ServerBatch batch = 6;
+  if (_internal_has_batch()) {
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(6, _Internal::batch(this),
+        _Internal::batch(this).GetCachedSize(), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::_pbi::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields<::PROTOBUF_NAMESPACE_ID::UnknownFieldSet>(::PROTOBUF_NAMESPACE_ID::UnknownFieldSet::default_instance), target, stream);
@@ -2440,6 +3025,11 @@ size_t ServerMessage::ByteSizeLong() const {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
+  // uint64 request_id = 5;
+  if (this->_internal_request_id() != 0) {
+    total_size += ::_pbi::WireFormatLite::UInt64SizePlusOne(this->_internal_request_id());
+  }
+
   // .MessageType type = 1;
   if (this->_internal_type() != 0) {
     total_size += 1 +
@@ -2468,6 +3058,13 @@ size_t ServerMessage::ByteSizeLong() const {
           *_impl_.payload_.dereg_ack_);
       break;
     }
+    // .ServerBatch batch = 6;
+    case kBatch: {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *_impl_.payload_.batch_);
+      break;
+    }
     case PAYLOAD_NOT_SET: {
       break;
     }
@@ -2490,6 +3087,9 @@ void ServerMessage::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::
   uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
+  if (from._internal_request_id() != 0) {
+    _this->_internal_set_request_id(from._internal_request_id());
+  }
   if (from._internal_type() != 0) {
     _this->_internal_set_type(from._internal_type());
   }
@@ -2509,6 +3109,11 @@ void ServerMessage::MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::
           from._internal_dereg_ack());
       break;
     }
+    case kBatch: {
+      _this->_internal_mutable_batch()->::ServerBatch::MergeFrom(
+          from._internal_batch());
+      break;
+    }
     case PAYLOAD_NOT_SET: {
       break;
     }
@@ -2530,7 +3135,12 @@ bool ServerMessage::IsInitialized() const {
 void ServerMessage::InternalSwap(ServerMessage* other) {
   using std::swap;
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
-  swap(_impl_.type_, other->_impl_.type_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(ServerMessage, _impl_.type_)
+      + sizeof(ServerMessage::_impl_.type_)
+      - PROTOBUF_FIELD_OFFSET(ServerMessage, _impl_.request_id_)>(
+          reinterpret_cast<char*>(&_impl_.request_id_),
+          reinterpret_cast<char*>(&other->_impl_.request_id_));
   swap(_impl_.payload_, other->_impl_.payload_);
   swap(_impl_._oneof_case_[0], other->_impl_._oneof_case_[0]);
 }
@@ -2538,7 +3148,7 @@ void ServerMessage::InternalSwap(ServerMessage* other) {
 ::PROTOBUF_NAMESPACE_ID::Metadata ServerMessage::GetMetadata() const {
   return ::_pbi::AssignDescriptors(
       &descriptor_table_message_2eproto_getter, &descriptor_table_message_2eproto_once,
-      file_level_metadata_message_2eproto[7]);
+      file_level_metadata_message_2eproto[9]);
 }
 
 // @@protoc_insertion_point(namespace_scope)
@@ -2567,6 +3177,14 @@ template<> PROTOBUF_NOINLINE ::DeregistrationAck*
 Arena::CreateMaybeMessage< ::DeregistrationAck >(Arena* arena) {
   return Arena::CreateMessageInternal< ::DeregistrationAck >(arena);
 }
+template<> PROTOBUF_NOINLINE ::ClientBatch*
+Arena::CreateMaybeMessage< ::ClientBatch >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::ClientBatch >(arena);
+}
+template<> PROTOBUF_NOINLINE ::ServerBatch*
+Arena::CreateMaybeMessage< ::ServerBatch >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::ServerBatch >(arena);
+}
 template<> PROTOBUF_NOINLINE ::ClientMessage*
 Arena::CreateMaybeMessage< ::ClientMessage >(Arena* arena) {
   return Arena::CreateMessageInternal< ::ClientMessage >(arena);
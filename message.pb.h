@@ -45,6 +45,9 @@ struct TableStruct_message_2eproto {
   static const uint32_t offsets[];
 };
 extern const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_message_2eproto;
+class ClientBatch;
+struct ClientBatchDefaultTypeInternal;
+extern ClientBatchDefaultTypeInternal _ClientBatch_default_instance_;
 class ClientMessage;
 struct ClientMessageDefaultTypeInternal;
 extern ClientMessageDefaultTypeInternal _ClientMessage_default_instance_;
@@ -66,10 +69,14 @@ extern RegistrationAckDefaultTypeInternal _RegistrationAck_default_instance_;
 class RegistrationRequest;
 struct RegistrationRequestDefaultTypeInternal;
 extern RegistrationRequestDefaultTypeInternal _RegistrationRequest_default_instance_;
+class ServerBatch;
+struct ServerBatchDefaultTypeInternal;
+extern ServerBatchDefaultTypeInternal _ServerBatch_default_instance_;
 class ServerMessage;
 struct ServerMessageDefaultTypeInternal;
 extern ServerMessageDefaultTypeInternal _ServerMessage_default_instance_;
 PROTOBUF_NAMESPACE_OPEN
+template<> ::ClientBatch* Arena::CreateMaybeMessage<::ClientBatch>(Arena*);
 template<> ::ClientMessage* Arena::CreateMaybeMessage<::ClientMessage>(Arena*);
 template<> ::DeregistrationAck* Arena::CreateMaybeMessage<::DeregistrationAck>(Arena*);
 template<> ::DeregistrationRequest* Arena::CreateMaybeMessage<::DeregistrationRequest>(Arena*);
@@ -77,6 +84,7 @@ template<> ::PduSessionAck* Arena::CreateMaybeMessage<::PduSessionAck>(Arena*);
 template<> ::PduSessionRequest* Arena::CreateMaybeMessage<::PduSessionRequest>(Arena*);
 template<> ::RegistrationAck* Arena::CreateMaybeMessage<::RegistrationAck>(Arena*);
 template<> ::RegistrationRequest* Arena::CreateMaybeMessage<::RegistrationRequest>(Arena*);
+template<> ::ServerBatch* Arena::CreateMaybeMessage<::ServerBatch>(Arena*);
 template<> ::ServerMessage* Arena::CreateMaybeMessage<::ServerMessage>(Arena*);
 PROTOBUF_NAMESPACE_CLOSE
 
@@ -87,12 +95,14 @@ enum MessageType : int {
   PDU_SESSION_ACK = 3,
   DEREGISTRATION_REQUEST = 4,
   DEREGISTRATION_ACK = 5,
+  BATCH_REQUEST = 6,
+  BATCH_ACK = 7,
   MessageType_INT_MIN_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::min(),
   MessageType_INT_MAX_SENTINEL_DO_NOT_USE_ = std::numeric_limits<int32_t>::max()
 };
 bool MessageType_IsValid(int value);
 constexpr MessageType MessageType_MIN = REGISTRATION_REQUEST;
-constexpr MessageType MessageType_MAX = DEREGISTRATION_ACK;
+constexpr MessageType MessageType_MAX = BATCH_ACK;
 constexpr int MessageType_ARRAYSIZE = MessageType_MAX + 1;
 
 const ::PROTOBUF_NAMESPACE_ID::EnumDescriptor* MessageType_descriptor();
@@ -1129,6 +1139,320 @@ class DeregistrationAck final :
 };
 // -------------------------------------------------------------------
 
+class ClientBatch final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:ClientBatch) */ {
+ public:
+  inline ClientBatch() : ClientBatch(nullptr) {}
+  ~ClientBatch() override;
+  explicit PROTOBUF_CONSTEXPR ClientBatch(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  ClientBatch(const ClientBatch& from);
+  ClientBatch(ClientBatch&& from) noexcept
+    : ClientBatch() {
+    *this = ::std::move(from);
+  }
+
+  inline ClientBatch& operator=(const ClientBatch& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline ClientBatch& operator=(ClientBatch&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const ClientBatch& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const ClientBatch* internal_default_instance() {
+    return reinterpret_cast<const ClientBatch*>(
+               &_ClientBatch_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    6;
+
+  friend void swap(ClientBatch& a, ClientBatch& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(ClientBatch* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(ClientBatch* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  ClientBatch* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<ClientBatch>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const ClientBatch& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const ClientBatch& from) {
+    ClientBatch::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(ClientBatch* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "ClientBatch";
+  }
+  protected:
+  explicit ClientBatch(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kMessagesFieldNumber = 1,
+  };
+  // repeated .ClientMessage messages = 1;
+  int messages_size() const;
+  private:
+  int _internal_messages_size() const;
+  public:
+  void clear_messages();
+  ::ClientMessage* mutable_messages(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::ClientMessage >*
+      mutable_messages();
+  private:
+  const ::ClientMessage& _internal_messages(int index) const;
+  ::ClientMessage* _internal_add_messages();
+  public:
+  const ::ClientMessage& messages(int index) const;
+  ::ClientMessage* add_messages();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::ClientMessage >&
+      messages() const;
+
+  // @@protoc_insertion_point(class_scope:ClientBatch)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::ClientMessage > messages_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_message_2eproto;
+};
+// -------------------------------------------------------------------
+
+class ServerBatch final :
+    public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:ServerBatch) */ {
+ public:
+  inline ServerBatch() : ServerBatch(nullptr) {}
+  ~ServerBatch() override;
+  explicit PROTOBUF_CONSTEXPR ServerBatch(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  ServerBatch(const ServerBatch& from);
+  ServerBatch(ServerBatch&& from) noexcept
+    : ServerBatch() {
+    *this = ::std::move(from);
+  }
+
+  inline ServerBatch& operator=(const ServerBatch& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline ServerBatch& operator=(ServerBatch&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* descriptor() {
+    return GetDescriptor();
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Descriptor* GetDescriptor() {
+    return default_instance().GetMetadata().descriptor;
+  }
+  static const ::PROTOBUF_NAMESPACE_ID::Reflection* GetReflection() {
+    return default_instance().GetMetadata().reflection;
+  }
+  static const ServerBatch& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const ServerBatch* internal_default_instance() {
+    return reinterpret_cast<const ServerBatch*>(
+               &_ServerBatch_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    7;
+
+  friend void swap(ServerBatch& a, ServerBatch& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(ServerBatch* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(ServerBatch* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  ServerBatch* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<ServerBatch>(arena);
+  }
+  using ::PROTOBUF_NAMESPACE_ID::Message::CopyFrom;
+  void CopyFrom(const ServerBatch& from);
+  using ::PROTOBUF_NAMESPACE_ID::Message::MergeFrom;
+  void MergeFrom( const ServerBatch& from) {
+    ServerBatch::MergeImpl(*this, from);
+  }
+  private:
+  static void MergeImpl(::PROTOBUF_NAMESPACE_ID::Message& to_msg, const ::PROTOBUF_NAMESPACE_ID::Message& from_msg);
+  public:
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _impl_._cached_size_.Get(); }
+
+  private:
+  void SharedCtor(::PROTOBUF_NAMESPACE_ID::Arena* arena, bool is_message_owned);
+  void SharedDtor();
+  void SetCachedSize(int size) const final;
+  void InternalSwap(ServerBatch* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "ServerBatch";
+  }
+  protected:
+  explicit ServerBatch(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  public:
+
+  static const ClassData _class_data_;
+  const ::PROTOBUF_NAMESPACE_ID::Message::ClassData*GetClassData() const final;
+
+  ::PROTOBUF_NAMESPACE_ID::Metadata GetMetadata() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kMessagesFieldNumber = 1,
+  };
+  // repeated .ServerMessage messages = 1;
+  int messages_size() const;
+  private:
+  int _internal_messages_size() const;
+  public:
+  void clear_messages();
+  ::ServerMessage* mutable_messages(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::ServerMessage >*
+      mutable_messages();
+  private:
+  const ::ServerMessage& _internal_messages(int index) const;
+  ::ServerMessage* _internal_add_messages();
+  public:
+  const ::ServerMessage& messages(int index) const;
+  ::ServerMessage* add_messages();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::ServerMessage >&
+      messages() const;
+
+  // @@protoc_insertion_point(class_scope:ServerBatch)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  struct Impl_ {
+    ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::ServerMessage > messages_;
+    mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  };
+  union { Impl_ _impl_; };
+  friend struct ::TableStruct_message_2eproto;
+};
+// -------------------------------------------------------------------
+
 class ClientMessage final :
     public ::PROTOBUF_NAMESPACE_ID::Message /* @@protoc_insertion_point(class_definition:ClientMessage) */ {
  public:
@@ -1176,6 +1500,7 @@ class ClientMessage final :
     kRegReq = 2,
     kPduReq = 3,
     kDeregReq = 4,
+    kBatch = 6,
     PAYLOAD_NOT_SET = 0,
   };
 
@@ -1184,7 +1509,7 @@ class ClientMessage final :
                &_ClientMessage_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    6;
+    8;
 
   friend void swap(ClientMessage& a, ClientMessage& b) {
     a.Swap(&b);
@@ -1257,11 +1582,22 @@ class ClientMessage final :
   // accessors -------------------------------------------------------
 
   enum : int {
+    kRequestIdFieldNumber = 5,
     kTypeFieldNumber = 1,
     kRegReqFieldNumber = 2,
     kPduReqFieldNumber = 3,
     kDeregReqFieldNumber = 4,
+    kBatchFieldNumber = 6,
   };
+  // uint64 request_id = 5;
+  void clear_request_id();
+  uint64_t request_id() const;
+  void set_request_id(uint64_t value);
+  private:
+  uint64_t _internal_request_id() const;
+  void _internal_set_request_id(uint64_t value);
+  public:
+
   // .MessageType type = 1;
   void clear_type();
   ::MessageType type() const;
@@ -1325,6 +1661,24 @@ class ClientMessage final :
       ::DeregistrationRequest* dereg_req);
   ::DeregistrationRequest* unsafe_arena_release_dereg_req();
 
+  // .ClientBatch batch = 6;
+  bool has_batch() const;
+  private:
+  bool _internal_has_batch() const;
+  public:
+  void clear_batch();
+  const ::ClientBatch& batch() const;
+  PROTOBUF_NODISCARD ::ClientBatch* release_batch();
+  ::ClientBatch* mutable_batch();
+  void set_allocated_batch(::ClientBatch* batch);
+  private:
+  const ::ClientBatch& _internal_batch() const;
+  ::ClientBatch* _internal_mutable_batch();
+  public:
+  void unsafe_arena_set_allocated_batch(
+      ::ClientBatch* batch);
+  ::ClientBatch* unsafe_arena_release_batch();
+
   void clear_payload();
   PayloadCase payload_case() const;
   // @@protoc_insertion_point(class_scope:ClientMessage)
@@ -1333,6 +1687,7 @@ class ClientMessage final :
   void set_has_reg_req();
   void set_has_pdu_req();
   void set_has_dereg_req();
+  void set_has_batch();
 
   inline bool has_payload() const;
   inline void clear_has_payload();
@@ -1341,6 +1696,7 @@ class ClientMessage final :
   typedef void InternalArenaConstructable_;
   typedef void DestructorSkippable_;
   struct Impl_ {
+    uint64_t request_id_;
     int type_;
     union PayloadUnion {
       constexpr PayloadUnion() : _constinit_{} {}
@@ -1348,6 +1704,7 @@ class ClientMessage final :
       ::RegistrationRequest* reg_req_;
       ::PduSessionRequest* pdu_req_;
       ::DeregistrationRequest* dereg_req_;
+      ::ClientBatch* batch_;
     } payload_;
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
     uint32_t _oneof_case_[1];
@@ -1405,6 +1762,7 @@ class ServerMessage final :
     kRegAck = 2,
     kPduAck = 3,
     kDeregAck = 4,
+    kBatch = 6,
     PAYLOAD_NOT_SET = 0,
   };
 
@@ -1413,7 +1771,7 @@ class ServerMessage final :
                &_ServerMessage_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    7;
+    9;
 
   friend void swap(ServerMessage& a, ServerMessage& b) {
     a.Swap(&b);
@@ -1486,11 +1844,22 @@ class ServerMessage final :
   // accessors -------------------------------------------------------
 
   enum : int {
+    kRequestIdFieldNumber = 5,
     kTypeFieldNumber = 1,
     kRegAckFieldNumber = 2,
     kPduAckFieldNumber = 3,
     kDeregAckFieldNumber = 4,
+    kBatchFieldNumber = 6,
   };
+  // uint64 request_id = 5;
+  void clear_request_id();
+  uint64_t request_id() const;
+  void set_request_id(uint64_t value);
+  private:
+  uint64_t _internal_request_id() const;
+  void _internal_set_request_id(uint64_t value);
+  public:
+
   // .MessageType type = 1;
   void clear_type();
   ::MessageType type() const;
@@ -1554,6 +1923,24 @@ class ServerMessage final :
       ::DeregistrationAck* dereg_ack);
   ::DeregistrationAck* unsafe_arena_release_dereg_ack();
 
+  // .ServerBatch batch = 6;
+  bool has_batch() const;
+  private:
+  bool _internal_has_batch() const;
+  public:
+  void clear_batch();
+  const ::ServerBatch& batch() const;
+  PROTOBUF_NODISCARD ::ServerBatch* release_batch();
+  ::ServerBatch* mutable_batch();
+  void set_allocated_batch(::ServerBatch* batch);
+  private:
+  const ::ServerBatch& _internal_batch() const;
+  ::ServerBatch* _internal_mutable_batch();
+  public:
+  void unsafe_arena_set_allocated_batch(
+      ::ServerBatch* batch);
+  ::ServerBatch* unsafe_arena_release_batch();
+
   void clear_payload();
   PayloadCase payload_case() const;
   // @@protoc_insertion_point(class_scope:ServerMessage)
@@ -1562,6 +1949,7 @@ class ServerMessage final :
   void set_has_reg_ack();
   void set_has_pdu_ack();
   void set_has_dereg_ack();
+  void set_has_batch();
 
   inline bool has_payload() const;
   inline void clear_has_payload();
@@ -1570,6 +1958,7 @@ class ServerMessage final :
   typedef void InternalArenaConstructable_;
   typedef void DestructorSkippable_;
   struct Impl_ {
+    uint64_t request_id_;
     int type_;
     union PayloadUnion {
       constexpr PayloadUnion() : _constinit_{} {}
@@ -1577,6 +1966,7 @@ class ServerMessage final :
       ::RegistrationAck* reg_ack_;
       ::PduSessionAck* pdu_ack_;
       ::DeregistrationAck* dereg_ack_;
+      ::ServerBatch* batch_;
     } payload_;
     mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
     uint32_t _oneof_case_[1];
@@ -2058,6 +2448,94 @@ inline void DeregistrationAck::set_allocated_status_message(std::string* status_
 
 // -------------------------------------------------------------------
 
+// ClientBatch
+
+// repeated .ClientMessage messages = 1;
+inline int ClientBatch::_internal_messages_size() const {
+  return _impl_.messages_.size();
+}
+inline int ClientBatch::messages_size() const {
+  return _internal_messages_size();
+}
+inline void ClientBatch::clear_messages() {
+  _impl_.messages_.Clear();
+}
+inline ::ClientMessage* ClientBatch::mutable_messages(int index) {
+  // @@protoc_insertion_point(field_mutable:ClientBatch.messages)
+  return _impl_.messages_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::ClientMessage >*
+ClientBatch::mutable_messages() {
+  // @@protoc_insertion_point(field_mutable_list:ClientBatch.messages)
+  return &_impl_.messages_;
+}
+inline const ::ClientMessage& ClientBatch::_internal_messages(int index) const {
+  return _impl_.messages_.Get(index);
+}
+inline const ::ClientMessage& ClientBatch::messages(int index) const {
+  // @@protoc_insertion_point(field_get:ClientBatch.messages)
+  return _internal_messages(index);
+}
+inline ::ClientMessage* ClientBatch::_internal_add_messages() {
+  return _impl_.messages_.Add();
+}
+inline ::ClientMessage* ClientBatch::add_messages() {
+  ::ClientMessage* _add = _internal_add_messages();
+  // @@protoc_insertion_point(field_add:ClientBatch.messages)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::ClientMessage >&
+ClientBatch::messages() const {
+  // @@protoc_insertion_point(field_list:ClientBatch.messages)
+  return _impl_.messages_;
+}
+
+// -------------------------------------------------------------------
+
+// ServerBatch
+
+// repeated .ServerMessage messages = 1;
+inline int ServerBatch::_internal_messages_size() const {
+  return _impl_.messages_.size();
+}
+inline int ServerBatch::messages_size() const {
+  return _internal_messages_size();
+}
+inline void ServerBatch::clear_messages() {
+  _impl_.messages_.Clear();
+}
+inline ::ServerMessage* ServerBatch::mutable_messages(int index) {
+  // @@protoc_insertion_point(field_mutable:ServerBatch.messages)
+  return _impl_.messages_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::ServerMessage >*
+ServerBatch::mutable_messages() {
+  // @@protoc_insertion_point(field_mutable_list:ServerBatch.messages)
+  return &_impl_.messages_;
+}
+inline const ::ServerMessage& ServerBatch::_internal_messages(int index) const {
+  return _impl_.messages_.Get(index);
+}
+inline const ::ServerMessage& ServerBatch::messages(int index) const {
+  // @@protoc_insertion_point(field_get:ServerBatch.messages)
+  return _internal_messages(index);
+}
+inline ::ServerMessage* ServerBatch::_internal_add_messages() {
+  return _impl_.messages_.Add();
+}
+inline ::ServerMessage* ServerBatch::add_messages() {
+  ::ServerMessage* _add = _internal_add_messages();
+  // @@protoc_insertion_point(field_add:ServerBatch.messages)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::ServerMessage >&
+ServerBatch::messages() const {
+  // @@protoc_insertion_point(field_list:ServerBatch.messages)
+  return _impl_.messages_;
+}
+
+// -------------------------------------------------------------------
+
 // ClientMessage
 
 // .MessageType type = 1;
@@ -2302,6 +2780,100 @@ inline ::DeregistrationRequest* ClientMessage::mutable_dereg_req() {
   return _msg;
 }
 
+// .ClientBatch batch = 6;
+inline bool ClientMessage::_internal_has_batch() const {
+  return payload_case() == kBatch;
+}
+inline bool ClientMessage::has_batch() const {
+  return _internal_has_batch();
+}
+inline void ClientMessage::set_has_batch() {
+  _impl_._oneof_case_[0] = kBatch;
+}
+inline void ClientMessage::clear_batch() {
+  if (_internal_has_batch()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.payload_.batch_;
+    }
+    clear_has_payload();
+  }
+}
+inline ::ClientBatch* ClientMessage::release_batch() {
+  // @@protoc_insertion_point(field_release:ClientMessage.batch)
+  if (_internal_has_batch()) {
+    clear_has_payload();
+    ::ClientBatch* temp = _impl_.payload_.batch_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.payload_.batch_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::ClientBatch& ClientMessage::_internal_batch() const {
+  return _internal_has_batch()
+      ? *_impl_.payload_.batch_
+      : reinterpret_cast< ::ClientBatch&>(::_ClientBatch_default_instance_);
+}
+inline const ::ClientBatch& ClientMessage::batch() const {
+  // @@protoc_insertion_point(field_get:ClientMessage.batch)
+  return _internal_batch();
+}
+inline ::ClientBatch* ClientMessage::unsafe_arena_release_batch() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:ClientMessage.batch)
+  if (_internal_has_batch()) {
+    clear_has_payload();
+    ::ClientBatch* temp = _impl_.payload_.batch_;
+    _impl_.payload_.batch_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void ClientMessage::unsafe_arena_set_allocated_batch(::ClientBatch* batch) {
+  clear_payload();
+  if (batch) {
+    set_has_batch();
+    _impl_.payload_.batch_ = batch;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:ClientMessage.batch)
+}
+inline ::ClientBatch* ClientMessage::_internal_mutable_batch() {
+  if (!_internal_has_batch()) {
+    clear_payload();
+    set_has_batch();
+    _impl_.payload_.batch_ = CreateMaybeMessage< ::ClientBatch >(GetArenaForAllocation());
+  }
+  return _impl_.payload_.batch_;
+}
+inline ::ClientBatch* ClientMessage::mutable_batch() {
+  ::ClientBatch* _msg = _internal_mutable_batch();
+  // @@protoc_insertion_point(field_mutable:ClientMessage.batch)
+  return _msg;
+}
+
+// uint64 request_id = 5;
+inline void ClientMessage::clear_request_id() {
+  _impl_.request_id_ = uint64_t{0u};
+}
+inline uint64_t ClientMessage::_internal_request_id() const {
+  return _impl_.request_id_;
+}
+inline uint64_t ClientMessage::request_id() const {
+  // @@protoc_insertion_point(field_get:ClientMessage.request_id)
+  return _internal_request_id();
+}
+inline void ClientMessage::_internal_set_request_id(uint64_t value) {
+  
+  _impl_.request_id_ = value;
+}
+inline void ClientMessage::set_request_id(uint64_t value) {
+  _internal_set_request_id(value);
+  // @@protoc_insertion_point(field_set:ClientMessage.request_id)
+}
+
 inline bool ClientMessage::has_payload() const {
   return payload_case() != PAYLOAD_NOT_SET;
 }
@@ -2557,6 +3129,100 @@ inline ::DeregistrationAck* ServerMessage::mutable_dereg_ack() {
   return _msg;
 }
 
+// .ServerBatch batch = 6;
+inline bool ServerMessage::_internal_has_batch() const {
+  return payload_case() == kBatch;
+}
+inline bool ServerMessage::has_batch() const {
+  return _internal_has_batch();
+}
+inline void ServerMessage::set_has_batch() {
+  _impl_._oneof_case_[0] = kBatch;
+}
+inline void ServerMessage::clear_batch() {
+  if (_internal_has_batch()) {
+    if (GetArenaForAllocation() == nullptr) {
+      delete _impl_.payload_.batch_;
+    }
+    clear_has_payload();
+  }
+}
+inline ::ServerBatch* ServerMessage::release_batch() {
+  // @@protoc_insertion_point(field_release:ServerMessage.batch)
+  if (_internal_has_batch()) {
+    clear_has_payload();
+    ::ServerBatch* temp = _impl_.payload_.batch_;
+    if (GetArenaForAllocation() != nullptr) {
+      temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+    }
+    _impl_.payload_.batch_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline const ::ServerBatch& ServerMessage::_internal_batch() const {
+  return _internal_has_batch()
+      ? *_impl_.payload_.batch_
+      : reinterpret_cast< ::ServerBatch&>(::_ServerBatch_default_instance_);
+}
+inline const ::ServerBatch& ServerMessage::batch() const {
+  // @@protoc_insertion_point(field_get:ServerMessage.batch)
+  return _internal_batch();
+}
+inline ::ServerBatch* ServerMessage::unsafe_arena_release_batch() {
+  // @@protoc_insertion_point(field_unsafe_arena_release:ServerMessage.batch)
+  if (_internal_has_batch()) {
+    clear_has_payload();
+    ::ServerBatch* temp = _impl_.payload_.batch_;
+    _impl_.payload_.batch_ = nullptr;
+    return temp;
+  } else {
+    return nullptr;
+  }
+}
+inline void ServerMessage::unsafe_arena_set_allocated_batch(::ServerBatch* batch) {
+  clear_payload();
+  if (batch) {
+    set_has_batch();
+    _impl_.payload_.batch_ = batch;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:ServerMessage.batch)
+}
+inline ::ServerBatch* ServerMessage::_internal_mutable_batch() {
+  if (!_internal_has_batch()) {
+    clear_payload();
+    set_has_batch();
+    _impl_.payload_.batch_ = CreateMaybeMessage< ::ServerBatch >(GetArenaForAllocation());
+  }
+  return _impl_.payload_.batch_;
+}
+inline ::ServerBatch* ServerMessage::mutable_batch() {
+  ::ServerBatch* _msg = _internal_mutable_batch();
+  // @@protoc_insertion_point(field_mutable:ServerMessage.batch)
+  return _msg;
+}
+
+// uint64 request_id = 5;
+inline void ServerMessage::clear_request_id() {
+  _impl_.request_id_ = uint64_t{0u};
+}
+inline uint64_t ServerMessage::_internal_request_id() const {
+  return _impl_.request_id_;
+}
+inline uint64_t ServerMessage::request_id() const {
+  // @@protoc_insertion_point(field_get:ServerMessage.request_id)
+  return _internal_request_id();
+}
+inline void ServerMessage::_internal_set_request_id(uint64_t value) {
+  
+  _impl_.request_id_ = value;
+}
+inline void ServerMessage::set_request_id(uint64_t value) {
+  _internal_set_request_id(value);
+  // @@protoc_insertion_point(field_set:ServerMessage.request_id)
+}
+
 inline bool ServerMessage::has_payload() const {
   return payload_case() != PAYLOAD_NOT_SET;
 }
@@ -2583,6 +3249,10 @@ inline ServerMessage::PayloadCase ServerMessage::payload_case() const {
 
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
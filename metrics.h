@@ -0,0 +1,188 @@
+// Low-overhead metrics for request threads: counters and HDR-style latency
+// histograms kept in per-thread shards. A shard is written only by its own
+// thread (a relaxed load+store per update, no locked instructions); readers
+// sum all shards into a snapshot while the writers keep running.
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Log-linear buckets: 2^HISTOGRAM_SUB_BITS linear sub-buckets per power of
+// two, i.e. about 3% relative error, up to 2^(HISTOGRAM_MAX_EXPONENT+1) ns
+// (~137 s). Larger values land in the last bucket; the exact maximum is
+// tracked separately.
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_SUB_BUCKETS (1u << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_MAX_EXPONENT 36
+#define HISTOGRAM_BUCKETS ((HISTOGRAM_MAX_EXPONENT - HISTOGRAM_SUB_BITS + 2) * HISTOGRAM_SUB_BUCKETS)
+
+inline uint64_t monotonic_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return uint64_t(now.tv_sec) * 1000000000ull + uint64_t(now.tv_nsec);
+}
+
+// Counter with a single writer thread
+class Counter {
+public:
+    void add(uint64_t n = 1) { value_.store(value_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    uint64_t get() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+// Summed view of one or more histograms
+struct HistogramSnapshot {
+    uint64_t counts[HISTOGRAM_BUCKETS] = {};
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+
+    // Upper bound of the bucket holding the q-quantile (0 < q <= 1), capped at max
+    uint64_t percentile(double q) const;
+};
+
+// Latency histogram in nanoseconds with a single writer thread
+class LatencyHistogram {
+public:
+    LatencyHistogram() {
+        for (auto& c : counts_) c.store(0, std::memory_order_relaxed);
+    }
+
+    void record(uint64_t ns) {
+        bump(counts_[bucket_index(ns)], 1);
+        bump(count_, 1);
+        bump(sum_, ns);
+        if (ns > max_.load(std::memory_order_relaxed)) max_.store(ns, std::memory_order_relaxed);
+    }
+
+    void add_to(HistogramSnapshot& snapshot) const {
+        if (count_.load(std::memory_order_relaxed) == 0) return;
+        for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+            snapshot.counts[i] += counts_[i].load(std::memory_order_relaxed);
+        }
+        snapshot.count += count_.load(std::memory_order_relaxed);
+        snapshot.sum += sum_.load(std::memory_order_relaxed);
+        uint64_t max = max_.load(std::memory_order_relaxed);
+        if (max > snapshot.max) snapshot.max = max;
+    }
+
+    static size_t bucket_index(uint64_t value) {
+        if (value < 2 * HISTOGRAM_SUB_BUCKETS) return static_cast<size_t>(value);
+        unsigned exponent = 63 - __builtin_clzll(value);
+        if (exponent > HISTOGRAM_MAX_EXPONENT) return HISTOGRAM_BUCKETS - 1;
+        unsigned shift = exponent - HISTOGRAM_SUB_BITS;
+        return (shift + 1) * HISTOGRAM_SUB_BUCKETS + static_cast<size_t>((value >> shift) - HISTOGRAM_SUB_BUCKETS);
+    }
+
+    // Largest value that maps to bucket 'index'
+    static uint64_t bucket_upper_bound(size_t index) {
+        if (index < 2 * HISTOGRAM_SUB_BUCKETS) return index;
+        unsigned shift = static_cast<unsigned>(index / HISTOGRAM_SUB_BUCKETS) - 1;
+        uint64_t lower = uint64_t(HISTOGRAM_SUB_BUCKETS + index % HISTOGRAM_SUB_BUCKETS) << shift;
+        return lower + (uint64_t(1) << shift) - 1;
+    }
+
+private:
+    static void bump(std::atomic<uint64_t>& value, uint64_t n) {
+        value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> counts_[HISTOGRAM_BUCKETS];
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+inline uint64_t HistogramSnapshot::percentile(double q) const {
+    if (count == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(q * count + 0.5);
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            uint64_t bound = LatencyHistogram::bucket_upper_bound(i);
+            return bound < max ? bound : max;
+        }
+    }
+    return max;
+}
+
+// Function to append one report line for 'snapshot': label, count, mean and
+// p50/p90/p99/p99.9/max in microseconds
+inline void append_latency_line(std::string& out, const std::string& label, const HistogramSnapshot& snapshot) {
+    char line[256];
+    snprintf(line, sizeof(line), "%-44s %10llu %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n", label.c_str(),
+             static_cast<unsigned long long>(snapshot.count),
+             snapshot.count ? snapshot.sum / 1e3 / snapshot.count : 0.0,
+             snapshot.percentile(0.50) / 1e3, snapshot.percentile(0.90) / 1e3,
+             snapshot.percentile(0.99) / 1e3, snapshot.percentile(0.999) / 1e3, snapshot.max / 1e3);
+    out += line;
+}
+
+#define LATENCY_HEADER "# latency (us)                                     count      mean       p50       p90       p99     p99.9       max\n"
+
+// One 'Shard' per thread that records metrics. Shards live as long as the
+// registry, so counts from exited threads are kept. Each thread caches its
+// shards keyed by registry ID, which is never reused, so any number of
+// registries (and ones created after others were destroyed) can coexist.
+template <typename Shard>
+class ShardedMetrics {
+public:
+    ShardedMetrics() : id_(next_id()) {}
+
+    ShardedMetrics(const ShardedMetrics&) = delete;
+    ShardedMetrics& operator=(const ShardedMetrics&) = delete;
+
+    Shard& local() {
+        struct Cached {
+            uint64_t registry;
+            Shard* shard;
+        };
+        static thread_local std::vector<Cached> cache;  // Most recently used first
+        if (!cache.empty() && cache.front().registry == id_) return *cache.front().shard;
+        for (size_t i = 1; i < cache.size(); ++i) {
+            if (cache[i].registry == id_) {
+                std::swap(cache[0], cache[i]);
+                return *cache[0].shard;
+            }
+        }
+        std::unique_ptr<Shard> fresh(new Shard());
+        Shard* shard = fresh.get();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shards_.push_back(std::move(fresh));
+        }
+        cache.insert(cache.begin(), Cached{id_, shard});
+        return *shard;
+    }
+
+    // Calls fn(shard) for every shard
+    template <typename Fn>
+    void for_each(Fn fn) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& shard : shards_) fn(*shard);
+    }
+
+private:
+    static uint64_t next_id() {
+        static std::atomic<uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const uint64_t id_;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+#endif // METRICS_H
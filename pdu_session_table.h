@@ -0,0 +1,266 @@
+// Per-subscriber PDU session table. Every subscriber owns one 64-byte entry:
+// a bit mask of the PDU IDs in use (1-15) and the S-NSSAI (sst/sd) of each
+// session. Entries live in lazily allocated 256-entry pages (16 KB), found
+// through a 2 KB group of page pointers per 65536-ID range, so dense IDs cost
+// 64 bytes per subscriber and even fully sparse IDs at most 18 KB each.
+// allocate/release are a few atomic ops with no heap allocation once the
+// subscriber's page exists (a page is allocated the first time its ID range
+// is used, and kept).
+// A snapshot (snapshot.h) stores the table as one SessionRecord per subscriber
+// with sessions. Loaded records, already verified by the snapshot, are copied
+// into a page only when its ID range is first used.
+#ifndef PDU_SESSION_TABLE_H
+#define PDU_SESSION_TABLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#define MAX_PDU_SESSIONS 15                     // PDU session IDs 1-15
+#define PDU_ID_MASK ((1u << MAX_PDU_SESSIONS) - 1)
+#define SESSION_PAGE_BITS 8                     // Subscribers per page: 256 (16 KB)
+#define SESSION_PAGE_SIZE (1u << SESSION_PAGE_BITS)
+#define SESSION_PAGE_COUNT (1u << (32 - SESSION_PAGE_BITS))
+#define SESSION_GROUP_BITS 16                   // Subscribers per group of pages: 65536
+#define SESSION_GROUP_PAGES (1u << (SESSION_GROUP_BITS - SESSION_PAGE_BITS))
+#define SESSION_GROUP_COUNT (1u << (32 - SESSION_GROUP_BITS))
+
+// One subscriber's sessions as stored in a snapshot (host byte order)
+struct SessionRecord {
+    uint32_t id;
+    uint32_t used;                          // Bit n: PDU ID n+1 allocated
+    uint32_t sessions[MAX_PDU_SESSIONS];    // 1 << 31 | sst << 16 | sd, or 0 if free
+};
+static_assert(sizeof(SessionRecord) == 68, "Session records must be 68 bytes");
+
+// Loaded records of one page's ID range (id >> SESSION_PAGE_BITS == index), sorted by ID
+struct SessionPageSource {
+    uint32_t index;
+    uint32_t count;
+    const SessionRecord* records;
+};
+
+class PduSessionTable {
+public:
+    PduSessionTable() : groups_(new std::atomic<Group*>[SESSION_GROUP_COUNT]()) {}
+
+    ~PduSessionTable() {
+        for (uint32_t g = 0; g < SESSION_GROUP_COUNT; ++g) {
+            Group* group = groups_[g].load(std::memory_order_relaxed);
+            if (group == nullptr) continue;
+            for (uint32_t p = 0; p < SESSION_GROUP_PAGES; ++p) delete group->pages[p].load(std::memory_order_relaxed);
+            delete group;
+        }
+    }
+
+    PduSessionTable(const PduSessionTable&) = delete;
+    PduSessionTable& operator=(const PduSessionTable&) = delete;
+
+    // Allocates the lowest free PDU ID for subscriber 'id' and records its
+    // sst/sd. Returns the PDU ID (1-15), or 0 if all 15 are in use.
+    int allocate(int id, uint8_t sst, uint16_t sd) {
+        Entry& entry = get_or_create_entry(static_cast<uint32_t>(id));
+        uint32_t used = entry.used.load(std::memory_order_acquire);
+        while (true) {
+            uint32_t free_ids = ~used & PDU_ID_MASK;
+            if (free_ids == 0) return 0;
+            uint32_t bit = __builtin_ctz(free_ids);  // Lowest free PDU ID
+            if (entry.used.compare_exchange_weak(used, used | (1u << bit), std::memory_order_acq_rel)) {
+                entry.sessions[bit].store(encode(sst, sd), std::memory_order_release);
+                return static_cast<int>(bit) + 1;
+            }
+        }
+    }
+
+    // Records session 'pdu_id' as allocated with the given sst/sd, as when the
+    // state is rebuilt from a log. Returns false if pdu_id is out of range.
+    bool restore(int id, int pdu_id, uint8_t sst, uint16_t sd) {
+        if (pdu_id < 1 || pdu_id > MAX_PDU_SESSIONS) return false;
+        Entry& entry = get_or_create_entry(static_cast<uint32_t>(id));
+        entry.sessions[pdu_id - 1].store(encode(sst, sd), std::memory_order_release);
+        entry.used.fetch_or(1u << (pdu_id - 1), std::memory_order_acq_rel);
+        return true;
+    }
+
+    // Looks up one session. Returns false if it is not allocated.
+    bool lookup(int id, int pdu_id, uint8_t& sst, uint16_t& sd) const {
+        const Entry* entry = find_entry(static_cast<uint32_t>(id));
+        if (entry == nullptr || pdu_id < 1 || pdu_id > MAX_PDU_SESSIONS) return false;
+        uint32_t session = entry->sessions[pdu_id - 1].load(std::memory_order_acquire);
+        if (!(session & SESSION_VALID)) return false;
+        sst = static_cast<uint8_t>(session >> 16);
+        sd = static_cast<uint16_t>(session);
+        return true;
+    }
+
+    // Bit (pdu_id - 1) is set for every active session of subscriber 'id'
+    uint32_t active_sessions(int id) const {
+        const Entry* entry = find_entry(static_cast<uint32_t>(id));
+        return entry == nullptr ? 0 : entry->used.load(std::memory_order_acquire);
+    }
+
+    // Frees one session. Returns false if it was not allocated.
+    bool release(int id, int pdu_id) {
+        Entry* entry = find_entry(static_cast<uint32_t>(id));
+        if (entry == nullptr || pdu_id < 1 || pdu_id > MAX_PDU_SESSIONS) return false;
+        uint32_t bit = 1u << (pdu_id - 1);
+        entry->sessions[pdu_id - 1].store(0, std::memory_order_relaxed);
+        return entry->used.fetch_and(~bit, std::memory_order_acq_rel) & bit;
+    }
+
+    // Frees every session of subscriber 'id'. Returns the number freed.
+    int release_all(int id) {
+        Entry* entry = find_entry(static_cast<uint32_t>(id));
+        if (entry == nullptr) return 0;
+        uint32_t used = entry->used.load(std::memory_order_acquire);
+        for (uint32_t bits = used; bits != 0; bits &= bits - 1) {
+            entry->sessions[__builtin_ctz(bits)].store(0, std::memory_order_relaxed);
+        }
+        entry->used.fetch_and(~used, std::memory_order_acq_rel);
+        return __builtin_popcount(used);
+    }
+
+    // Number of active sessions; walks the whole table, so not for the hot path
+    size_t size() const {
+        size_t total = 0;
+        export_sessions([&](const SessionRecord& record) { total += __builtin_popcount(record.used); });
+        return total;
+    }
+
+    // Takes loaded records (ascending by page index) as the initial contents,
+    // before the table serves requests. 'owner' keeps the records' memory alive.
+    void load_base(const std::vector<SessionPageSource>& pages, std::shared_ptr<const void> owner) {
+        base_ = pages;
+        base_groups_.reset(new uint32_t[SESSION_GROUP_COUNT + 1]());
+        for (const SessionPageSource& page : base_) ++base_groups_[(page.index >> GROUP_SHIFT) + 1];
+        for (uint32_t g = 0; g < SESSION_GROUP_COUNT; ++g) base_groups_[g + 1] += base_groups_[g];
+        base_owner_ = std::move(owner);
+    }
+
+    // Function to call fn(record) for every subscriber with sessions, in
+    // ascending ID order. Sessions changed meanwhile may or may not be seen.
+    void export_sessions(const std::function<void(const SessionRecord&)>& fn) const {
+        SessionRecord record;
+        size_t next_source = 0;  // Loaded pages are walked alongside, in the same order
+        for (uint32_t g = 0; g < SESSION_GROUP_COUNT; ++g) {
+            size_t end_source = base_groups_ ? base_groups_[g + 1] : 0;
+            Group* group = groups_[g].load(std::memory_order_acquire);
+            for (uint32_t p = 0; p < SESSION_GROUP_PAGES; ++p) {
+                if (group == nullptr && next_source == end_source) break;
+                uint32_t index = g << GROUP_SHIFT | p;
+                const SessionPageSource* source = nullptr;
+                if (next_source < end_source && base_[next_source].index == index) source = &base_[next_source++];
+                Page* page = group == nullptr ? nullptr : group->pages[p].load(std::memory_order_acquire);
+                if (page == nullptr) {
+                    if (source == nullptr) continue;
+                    for (uint32_t r = 0; r < source->count; ++r) fn(source->records[r]);
+                    continue;
+                }
+                for (uint32_t e = 0; e < SESSION_PAGE_SIZE; ++e) {
+                    const Entry& entry = page->entries[e];
+                    record.used = entry.used.load(std::memory_order_acquire);
+                    if (record.used == 0) continue;
+                    record.id = index << SESSION_PAGE_BITS | e;
+                    for (int s = 0; s < MAX_PDU_SESSIONS; ++s) {
+                        record.sessions[s] = entry.sessions[s].load(std::memory_order_relaxed);
+                    }
+                    fn(record);
+                }
+            }
+        }
+    }
+
+private:
+    static const uint32_t SESSION_VALID = 1u << 31;
+    static const uint32_t GROUP_SHIFT = SESSION_GROUP_BITS - SESSION_PAGE_BITS;
+
+    // One cache line per subscriber
+    struct Entry {
+        std::atomic<uint32_t> used;                        // Bit n: PDU ID n+1 allocated
+        std::atomic<uint32_t> sessions[MAX_PDU_SESSIONS];  // SESSION_VALID | sst << 16 | sd
+    };
+    static_assert(sizeof(Entry) == 64, "PDU session entry must fill one cache line");
+
+    struct Page {
+        Entry entries[SESSION_PAGE_SIZE];
+    };
+
+    // Pages of one 65536-ID range
+    struct Group {
+        std::atomic<Page*> pages[SESSION_GROUP_PAGES];
+    };
+
+    static uint32_t encode(uint8_t sst, uint16_t sd) {
+        return SESSION_VALID | (uint32_t(sst) << 16) | sd;
+    }
+
+    Page* find_page(uint32_t index) const {
+        Group* group = groups_[index >> GROUP_SHIFT].load(std::memory_order_acquire);
+        return group == nullptr ? nullptr : group->pages[index & (SESSION_GROUP_PAGES - 1)].load(std::memory_order_acquire);
+    }
+
+    Entry* find_entry(uint32_t key) const {
+        Page* page = find_page(key >> SESSION_PAGE_BITS);
+        if (page == nullptr && !base_.empty()) page = install_page(key >> SESSION_PAGE_BITS, false);
+        return page == nullptr ? nullptr : &page->entries[key & (SESSION_PAGE_SIZE - 1)];
+    }
+
+    Entry& get_or_create_entry(uint32_t key) {
+        Page* page = find_page(key >> SESSION_PAGE_BITS);
+        if (page == nullptr) page = install_page(key >> SESSION_PAGE_BITS, true);
+        return page->entries[key & (SESSION_PAGE_SIZE - 1)];
+    }
+
+    // Groups are allocated on first use of their range and kept
+    Group& get_or_create_group(uint32_t g) const {
+        Group* group = groups_[g].load(std::memory_order_acquire);
+        if (group != nullptr) return *group;
+        Group* fresh = new Group();  // Value-initialized: no pages
+        if (groups_[g].compare_exchange_strong(group, fresh, std::memory_order_acq_rel)) return *fresh;
+        delete fresh;  // Another thread installed the group first
+        return *group;
+    }
+
+    // Loaded records of page 'index', or nullptr if none
+    const SessionPageSource* find_source(uint32_t index) const {
+        if (base_.empty()) return nullptr;
+        auto first = base_.begin() + base_groups_[index >> GROUP_SHIFT];
+        auto last = base_.begin() + base_groups_[(index >> GROUP_SHIFT) + 1];
+        auto it = std::lower_bound(first, last, index,
+                                   [](const SessionPageSource& page, uint32_t value) { return page.index < value; });
+        return it != last && it->index == index ? &*it : nullptr;
+    }
+
+    // Function to allocate page 'index', filled from its loaded records if
+    // any; without records, only if 'create'. Returns the installed page.
+    Page* install_page(uint32_t index, bool create) const {
+        const SessionPageSource* source = find_source(index);
+        if (source == nullptr && !create) return nullptr;
+
+        Page* fresh = new Page();  // Value-initialized: no sessions
+        for (uint32_t r = 0; source != nullptr && r < source->count; ++r) {
+            const SessionRecord& record = source->records[r];
+            Entry& entry = fresh->entries[record.id & (SESSION_PAGE_SIZE - 1)];
+            entry.used.store(record.used, std::memory_order_relaxed);
+            for (int s = 0; s < MAX_PDU_SESSIONS; ++s) {
+                entry.sessions[s].store(record.sessions[s], std::memory_order_relaxed);
+            }
+        }
+        std::atomic<Page*>& slot = get_or_create_group(index >> GROUP_SHIFT).pages[index & (SESSION_GROUP_PAGES - 1)];
+        Page* page = nullptr;
+        if (slot.compare_exchange_strong(page, fresh, std::memory_order_acq_rel)) return fresh;
+        delete fresh;  // Another thread installed the page first
+        return page;
+    }
+
+    std::unique_ptr<std::atomic<Group*>[]> groups_;
+    std::vector<SessionPageSource> base_;         // Loaded records by page, ascending
+    std::unique_ptr<uint32_t[]> base_groups_;     // Group g's pages are base_[base_groups_[g], base_groups_[g + 1])
+    std::shared_ptr<const void> base_owner_;
+};
+
+#endif // PDU_SESSION_TABLE_H
@@ -0,0 +1,337 @@
+// Thread-safe set of registered subscriber IDs shared by all request threads,
+// with two interchangeable backends:
+//  - ShardedRegistrationStore: IDs spread over independently locked hash-set
+//    shards, each on its own cache lines. Suits sparse ID spaces.
+//  - BitmapRegistrationStore: one bit per ID in lazily allocated pages over
+//    the 32-bit ID space; every operation is a single atomic bit op. Suits
+//    dense ID ranges (10M subscribers take a little over 1 MB).
+// Both load and save their contents as bitmap pages, the layout of a
+// snapshot (snapshot.h). The bitmap store serves loaded pages in place and
+// copies one only when it is first written to.
+#ifndef REGISTRATION_STORE_H
+#define REGISTRATION_STORE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#define CACHE_LINE_SIZE 64
+#define DEFAULT_STORE_SHARDS 64
+#define BITMAP_PAGE_BITS 16                                // IDs per page: 65536 (8 KB)
+#define BITMAP_PAGE_WORDS ((1u << BITMAP_PAGE_BITS) / 64)
+#define BITMAP_PAGE_COUNT (1u << (32 - BITMAP_PAGE_BITS))
+
+// One bitmap page of a snapshot: bit (id & 63) of words[(id & 0xFFFF) >> 6]
+// is set for each registered ID of range 'index' (id >> 16)
+struct RegistrationPage {
+    uint32_t index;
+    const uint64_t* words;   // BITMAP_PAGE_WORDS words
+};
+
+class RegistrationStore {
+public:
+    virtual ~RegistrationStore() {}
+
+    // Returns true if the ID was not registered before
+    virtual bool register_id(int id) = 0;
+    virtual bool is_registered(int id) const = 0;
+    // Returns true if the ID was registered
+    virtual bool deregister_id(int id) = 0;
+    // Number of registered IDs; walks the whole store, so not for the hot path
+    virtual size_t size() const = 0;
+
+    // Batch forms for bulk provisioning: changed[i] is set to 1 if ids[i] was
+    // (de)registered by this call, as the single-ID calls would return.
+    // Backends may visit the IDs in any order, but repeats of one ID are
+    // applied in batch order.
+    virtual void register_ids(const int* ids, size_t count, uint8_t* changed) {
+        for (size_t i = 0; i < count; ++i) changed[i] = register_id(ids[i]);
+    }
+
+    virtual void deregister_ids(const int* ids, size_t count, uint8_t* changed) {
+        for (size_t i = 0; i < count; ++i) changed[i] = deregister_id(ids[i]);
+    }
+
+    // Registers every ID set in 'pages', into an empty store before it
+    // serves requests. 'owner' keeps the pages' memory alive; backends that
+    // serve from the pages directly hold on to it.
+    virtual void load_pages(const std::vector<RegistrationPage>& pages, std::shared_ptr<const void> owner) {
+        (void)owner;
+        std::vector<int> ids;
+        std::vector<uint8_t> changed;
+        for (const RegistrationPage& page : pages) {
+            ids.clear();
+            for (uint32_t w = 0; w < BITMAP_PAGE_WORDS; ++w) {
+                for (uint64_t bits = page.words[w]; bits != 0; bits &= bits - 1) {
+                    ids.push_back(static_cast<int>(page.index << BITMAP_PAGE_BITS | w << 6 | __builtin_ctzll(bits)));
+                }
+            }
+            changed.resize(ids.size());
+            register_ids(ids.data(), ids.size(), changed.data());
+        }
+    }
+
+    // Function to call fn(index, words) for every page holding a registered
+    // ID, in ascending order. IDs changed meanwhile may or may not be seen.
+    virtual void export_pages(const std::function<void(uint32_t, const uint64_t*)>& fn) const = 0;
+};
+
+class ShardedRegistrationStore : public RegistrationStore {
+public:
+    // shard_count is rounded up to a power of two
+    explicit ShardedRegistrationStore(size_t shard_count = DEFAULT_STORE_SHARDS) {
+        shard_count_ = 1;
+        while (shard_count_ < shard_count) shard_count_ <<= 1;
+        shard_bits_ = 0;
+        while ((size_t(1) << shard_bits_) < shard_count_) ++shard_bits_;
+
+        void* memory = nullptr;
+        if (posix_memalign(&memory, CACHE_LINE_SIZE, shard_count_ * sizeof(Shard)) != 0) {
+            throw std::bad_alloc();
+        }
+        shards_ = static_cast<Shard*>(memory);
+        for (size_t i = 0; i < shard_count_; ++i) new (&shards_[i]) Shard();
+    }
+
+    ~ShardedRegistrationStore() override {
+        for (size_t i = 0; i < shard_count_; ++i) shards_[i].~Shard();
+        free(shards_);
+    }
+
+    ShardedRegistrationStore(const ShardedRegistrationStore&) = delete;
+    ShardedRegistrationStore& operator=(const ShardedRegistrationStore&) = delete;
+
+    bool register_id(int id) override {
+        Shard& shard = shard_for(id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.ids.insert(id).second;
+    }
+
+    bool is_registered(int id) const override {
+        const Shard& shard = shard_for(id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.ids.count(id) != 0;
+    }
+
+    bool deregister_id(int id) override {
+        Shard& shard = shard_for(id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        return shard.ids.erase(id) != 0;
+    }
+
+    size_t size() const override {
+        size_t total = 0;
+        for (size_t i = 0; i < shard_count_; ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            total += shards_[i].ids.size();
+        }
+        return total;
+    }
+
+    // Each shard is locked once per batch, and grown once before its inserts
+    void register_ids(const int* ids, size_t count, uint8_t* changed) override {
+        for_each_shard(ids, count, [&](Shard& shard, const uint32_t* items, size_t n) {
+            shard.ids.reserve(shard.ids.size() + n);
+            for (size_t k = 0; k < n; ++k) changed[items[k]] = shard.ids.insert(ids[items[k]]).second;
+        });
+    }
+
+    void deregister_ids(const int* ids, size_t count, uint8_t* changed) override {
+        for_each_shard(ids, count, [&](Shard& shard, const uint32_t* items, size_t n) {
+            for (size_t k = 0; k < n; ++k) changed[items[k]] = shard.ids.erase(ids[items[k]]) != 0;
+        });
+    }
+
+    // Copies each shard under its lock, then builds the pages from the sorted IDs
+    void export_pages(const std::function<void(uint32_t, const uint64_t*)>& fn) const override {
+        std::vector<uint32_t> keys;
+        for (size_t i = 0; i < shard_count_; ++i) {
+            std::lock_guard<std::mutex> lock(shards_[i].mutex);
+            for (int id : shards_[i].ids) keys.push_back(static_cast<uint32_t>(id));
+        }
+        std::sort(keys.begin(), keys.end());
+        std::vector<uint64_t> words(BITMAP_PAGE_WORDS);
+        for (size_t i = 0; i < keys.size();) {
+            uint32_t index = keys[i] >> BITMAP_PAGE_BITS;
+            std::fill(words.begin(), words.end(), 0);
+            for (; i < keys.size() && keys[i] >> BITMAP_PAGE_BITS == index; ++i) {
+                words[(keys[i] & ((1u << BITMAP_PAGE_BITS) - 1)) >> 6] |= uint64_t(1) << (keys[i] & 63);
+            }
+            fn(index, words.data());
+        }
+    }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        mutable std::mutex mutex;
+        std::unordered_set<int> ids;
+    };
+
+    // Fibonacci hashing: neighbouring IDs land on different shards
+    size_t shard_index(int id) const {
+        if (shard_bits_ == 0) return 0;
+        uint64_t h = static_cast<uint32_t>(id) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h >> (64 - shard_bits_));
+    }
+
+    Shard& shard_for(int id) { return shards_[shard_index(id)]; }
+    const Shard& shard_for(int id) const { return shards_[shard_index(id)]; }
+
+    // Function to group a batch by shard (a stable counting sort of the
+    // indices) and call fn(shard, indices, n) for each shard under its lock
+    template <typename Fn>
+    void for_each_shard(const int* ids, size_t count, Fn fn) {
+        thread_local std::vector<size_t> starts;
+        thread_local std::vector<uint32_t> order;
+        starts.assign(shard_count_ + 1, 0);
+        for (size_t i = 0; i < count; ++i) ++starts[shard_index(ids[i]) + 1];
+        for (size_t s = 0; s < shard_count_; ++s) starts[s + 1] += starts[s];
+        order.resize(count);
+        for (size_t i = 0; i < count; ++i) order[starts[shard_index(ids[i])]++] = static_cast<uint32_t>(i);
+
+        // starts[s] now holds the end of shard s
+        size_t begin = 0;
+        for (size_t s = 0; s < shard_count_; ++s) {
+            size_t end = starts[s];
+            if (end == begin) continue;
+            std::lock_guard<std::mutex> lock(shards_[s].mutex);
+            fn(shards_[s], order.data() + begin, end - begin);
+            begin = end;
+        }
+    }
+
+    Shard* shards_;
+    size_t shard_count_;
+    unsigned shard_bits_;
+};
+
+class BitmapRegistrationStore : public RegistrationStore {
+public:
+    BitmapRegistrationStore() : pages_(new std::atomic<Page*>[BITMAP_PAGE_COUNT]()) {}
+
+    ~BitmapRegistrationStore() override {
+        for (uint32_t i = 0; i < BITMAP_PAGE_COUNT; ++i) {
+            delete pages_[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    BitmapRegistrationStore(const BitmapRegistrationStore&) = delete;
+    BitmapRegistrationStore& operator=(const BitmapRegistrationStore&) = delete;
+
+    bool register_id(int id) override {
+        uint32_t key = static_cast<uint32_t>(id);
+        uint64_t mask = bit_mask(key);
+        return !(word(get_or_create_page(key), key).fetch_or(mask, std::memory_order_acq_rel) & mask);
+    }
+
+    bool is_registered(int id) const override {
+        uint32_t key = static_cast<uint32_t>(id);
+        Page* page = pages_[key >> BITMAP_PAGE_BITS].load(std::memory_order_acquire);
+        if (page == nullptr) {
+            const uint64_t* base = base_page(key >> BITMAP_PAGE_BITS);
+            return base != nullptr && (base[word_index(key)] & bit_mask(key));
+        }
+        return word(page, key).load(std::memory_order_acquire) & bit_mask(key);
+    }
+
+    bool deregister_id(int id) override {
+        uint32_t key = static_cast<uint32_t>(id);
+        Page* page = pages_[key >> BITMAP_PAGE_BITS].load(std::memory_order_acquire);
+        if (page == nullptr) {
+            if (base_page(key >> BITMAP_PAGE_BITS) == nullptr) return false;
+            page = get_or_create_page(key);
+        }
+        uint64_t mask = bit_mask(key);
+        return word(page, key).fetch_and(~mask, std::memory_order_acq_rel) & mask;
+    }
+
+    size_t size() const override {
+        size_t total = 0;
+        export_pages([&](uint32_t, const uint64_t* words) {
+            for (uint32_t w = 0; w < BITMAP_PAGE_WORDS; ++w) total += __builtin_popcountll(words[w]);
+        });
+        return total;
+    }
+
+    // Serves the pages in place until each is first written to
+    void load_pages(const std::vector<RegistrationPage>& pages, std::shared_ptr<const void> owner) override {
+        base_.reset(new const uint64_t*[BITMAP_PAGE_COUNT]());
+        for (const RegistrationPage& page : pages) base_[page.index] = page.words;
+        base_owner_ = std::move(owner);
+    }
+
+    void export_pages(const std::function<void(uint32_t, const uint64_t*)>& fn) const override {
+        uint64_t copy[BITMAP_PAGE_WORDS];
+        for (uint32_t i = 0; i < BITMAP_PAGE_COUNT; ++i) {
+            const uint64_t* words = base_page(i);
+            Page* page = pages_[i].load(std::memory_order_acquire);
+            if (page != nullptr) {
+                for (uint32_t w = 0; w < BITMAP_PAGE_WORDS; ++w) {
+                    copy[w] = page->words[w].load(std::memory_order_relaxed);
+                }
+                words = copy;
+            }
+            if (words != nullptr && std::any_of(words, words + BITMAP_PAGE_WORDS, [](uint64_t w) { return w != 0; })) {
+                fn(i, words);
+            }
+        }
+    }
+
+private:
+    struct Page {
+        std::atomic<uint64_t> words[BITMAP_PAGE_WORDS];
+    };
+
+    static uint64_t bit_mask(uint32_t key) { return uint64_t(1) << (key & 63); }
+
+    static uint32_t word_index(uint32_t key) { return (key & ((1u << BITMAP_PAGE_BITS) - 1)) >> 6; }
+
+    static std::atomic<uint64_t>& word(Page* page, uint32_t key) {
+        return page->words[word_index(key)];
+    }
+
+    // Loaded page of range 'index' (only read while it has no Page), or nullptr
+    const uint64_t* base_page(uint32_t index) const {
+        return base_ ? base_[index] : nullptr;
+    }
+
+    // Pages are allocated on first write in their range, from the loaded page if any, and kept
+    Page* get_or_create_page(uint32_t key) {
+        std::atomic<Page*>& slot = pages_[key >> BITMAP_PAGE_BITS];
+        Page* page = slot.load(std::memory_order_acquire);
+        if (page != nullptr) return page;
+
+        Page* fresh = new Page();  // Value-initialized: all bits clear
+        if (const uint64_t* base = base_page(key >> BITMAP_PAGE_BITS)) {
+            for (uint32_t w = 0; w < BITMAP_PAGE_WORDS; ++w) fresh->words[w].store(base[w], std::memory_order_relaxed);
+        }
+        if (slot.compare_exchange_strong(page, fresh, std::memory_order_acq_rel)) {
+            return fresh;
+        }
+        delete fresh;  // Another thread installed the page first
+        return page;
+    }
+
+    std::unique_ptr<std::atomic<Page*>[]> pages_;
+    std::unique_ptr<const uint64_t*[]> base_;   // Loaded pages by range, or nullptr if none
+    std::shared_ptr<const void> base_owner_;
+};
+
+// Function to create a store by backend name ("sharded" or "bitmap").
+// Returns nullptr for an unknown name.
+inline std::unique_ptr<RegistrationStore> make_registration_store(const std::string& backend) {
+    if (backend == "sharded") return std::unique_ptr<RegistrationStore>(new ShardedRegistrationStore());
+    if (backend == "bitmap") return std::unique_ptr<RegistrationStore>(new BitmapRegistrationStore());
+    return nullptr;
+}
+
+#endif // REGISTRATION_STORE_H
@@ -0,0 +1,683 @@
+// Trace replay driver. Reads a JSONL trace with one request per line:
+//
+//   {"ts": 0.000000, "type": "REGISTRATION_REQUEST", "id": 7}
+//   {"ts": 0.000250, "type": "PDU_SESSION_REQUEST", "id": 7, "sst": 1, "sd": "0001"}
+//   {"ts": 0.000900, "type": "DEREGISTRATION_REQUEST", "id": 7}
+//
+// "ts" is the request's time in seconds (only differences matter). Every
+// request is converted to a ClientMessage once while the trace is streamed
+// in, and its wire form (legacy, framed or HTTP) is appended to one
+// contiguous buffer, so replaying is a memcpy per request. Requests of one
+// subscriber always go over the same connection, in trace order.
+//
+// --speed 1 replays at the original timing, --speed N N times faster and
+// --speed 0 as fast as the window allows. With a speed, latency is measured
+// from each request's scheduled time, so a server that falls behind shows
+// up in the percentiles instead of slowing the replay down.
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <getopt.h>
+#include <unordered_map>
+#include <deque>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <strings.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include "message.pb.h"
+#include "framing.h"
+#include "metrics.h"
+
+#define DEFAULT_PORT 8081
+#define DEFAULT_SERVER_IP "127.0.0.1"
+#define REPLAY_EVENTS 256      // epoll events handled per wakeup
+#define REPLAY_READ_CHUNK 16384
+
+// Wire protocol of the target server
+enum ReplayTarget {
+    TARGET_TCP,      // server.cpp, one connection per request
+    TARGET_FRAMED,   // server.cpp --framed
+    TARGET_HTTP      // serverAPI.cpp, HTTP/1.1 keep-alive
+};
+
+struct ReplayOptions {
+    std::string server_ip = DEFAULT_SERVER_IP;
+    int port = DEFAULT_PORT;
+    ReplayTarget target = TARGET_TCP;
+    int window = 1;               // Requests in flight per connection (framed and HTTP)
+    int threads = 1;
+    int connections = 1;          // Per thread
+    double speed = 1;             // Timing multiplier; 0 = as fast as possible
+    int timeout = 10;             // Give up after this many seconds with requests in flight and no progress
+    std::string path = "-";       // Trace file, "-" for stdin
+};
+
+// One trace request: 32 bytes plus its wire bytes in Trace::wire
+struct TraceRequest {
+    uint64_t at_ns;      // Offset from the first request in the trace
+    uint64_t offset;     // Wire form: Trace::wire[offset, offset + len)
+    uint32_t len;
+    uint32_t request_id; // Carried in the wire form: the trace line's position
+    int32_t id;          // Subscriber ID; picks the connection
+    uint8_t slot;        // Request type: 0 REGISTRATION, 1 PDU_SESSION, 2 DEREGISTRATION
+};
+
+struct Trace {
+    std::string wire;
+    std::vector<TraceRequest> requests;   // Ordered by at_ns
+};
+
+// Function to find a field of a flat JSON object. Sets 'value' to the string
+// contents or the bare number/literal; returns false if the key is missing.
+bool json_field(const std::string& line, const char* key, std::string& value) {
+    std::string quoted = std::string("\"") + key + "\"";
+    size_t pos = 0;
+    while ((pos = line.find(quoted, pos)) != std::string::npos) {
+        size_t p = line.find_first_not_of(" \t", pos + quoted.size());
+        pos += quoted.size();
+        if (p == std::string::npos || line[p] != ':') continue;  // A string value that happens to match
+        p = line.find_first_not_of(" \t", p + 1);
+        if (p == std::string::npos) return false;
+        if (line[p] == '"') {
+            size_t end = line.find('"', p + 1);
+            if (end == std::string::npos) return false;
+            value = line.substr(p + 1, end - p - 1);
+        } else {
+            size_t end = line.find_first_of(",} \t\r", p);
+            value = line.substr(p, end == std::string::npos ? std::string::npos : end - p);
+        }
+        return true;
+    }
+    return false;
+}
+
+// Function to append the HTTP request serverAPI.cpp expects for 'message'
+void append_http_request(const ClientMessage& message, const std::string& host, std::string& out) {
+    const char* method = "POST";
+    const char* path;
+    std::string body;
+    switch (message.type()) {
+        case REGISTRATION_REQUEST:
+            path = "/register";
+            body = "{\"id\":" + std::to_string(message.reg_req().id()) + "}";
+            break;
+        case PDU_SESSION_REQUEST:
+            path = "/pdu-session";
+            body = "{\"id\":" + std::to_string(message.pdu_req().id()) + ",\"sst\":" +
+                   std::to_string(message.pdu_req().sst()) + ",\"sd\":\"" + message.pdu_req().sd() + "\"}";
+            break;
+        default:
+            method = "DELETE";
+            path = "/deregister";
+            body = "{\"id\":" + std::to_string(message.dereg_req().id()) + "}";
+            break;
+    }
+    out += std::string(method) + " " + path + " HTTP/1.1\r\nHost: " + host +
+           "\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+// Function to parse one trace line into 'message'. Returns false with 'error' set if it is invalid.
+bool parse_trace_line(const std::string& line, ClientMessage& message, double& ts, std::string& error) {
+    std::string type, value;
+    if (!json_field(line, "type", type)) {
+        error = "missing \"type\"";
+        return false;
+    }
+    ts = json_field(line, "ts", value) ? std::atof(value.c_str()) : 0;
+    if (!json_field(line, "id", value)) {
+        error = "missing \"id\"";
+        return false;
+    }
+    int id = std::atoi(value.c_str());
+
+    message.Clear();
+    if (type == "REGISTRATION_REQUEST") {
+        message.set_type(REGISTRATION_REQUEST);
+        message.mutable_reg_req()->set_id(id);
+    } else if (type == "PDU_SESSION_REQUEST") {
+        std::string sd;
+        if (!json_field(line, "sst", value) || !json_field(line, "sd", sd)) {
+            error = "PDU_SESSION_REQUEST needs \"sst\" and \"sd\"";
+            return false;
+        }
+        message.set_type(PDU_SESSION_REQUEST);
+        message.mutable_pdu_req()->set_id(id);
+        message.mutable_pdu_req()->set_sst(std::atoi(value.c_str()));
+        message.mutable_pdu_req()->set_sd(sd);
+    } else if (type == "DEREGISTRATION_REQUEST") {
+        message.set_type(DEREGISTRATION_REQUEST);
+        message.mutable_dereg_req()->set_id(id);
+    } else {
+        error = "unknown type " + type;
+        return false;
+    }
+    return true;
+}
+
+// Function to stream a trace in and convert every request to its wire form
+bool load_trace(const ReplayOptions& options, Trace& trace) {
+    std::ifstream file;
+    if (options.path != "-") {
+        file.open(options.path);
+        if (!file) {
+            std::cerr << "Cannot open trace " << options.path << std::endl;
+            return false;
+        }
+    }
+    std::istream& in = options.path == "-" ? std::cin : file;
+    std::string host = options.server_ip + ":" + std::to_string(options.port);
+
+    ClientMessage message;
+    std::string line, error;
+    double first_ts = 0;
+    int64_t earliest_ns = 0;
+    bool sorted = true;
+    size_t line_number = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        double ts;
+        if (!parse_trace_line(line, message, ts, error)) {
+            std::cerr << options.path << ":" << line_number << ": " << error << std::endl;
+            return false;
+        }
+        if (trace.requests.empty()) first_ts = ts;
+
+        // Relative to the first line for now; shifted below if an earlier line follows
+        TraceRequest request;
+        int64_t at_ns = static_cast<int64_t>((ts - first_ts) * 1e9);
+        earliest_ns = std::min(earliest_ns, at_ns);
+        request.at_ns = static_cast<uint64_t>(at_ns);
+        request.offset = trace.wire.size();
+        request.slot = static_cast<uint8_t>(message.type() / 2);
+        request.id = message.type() == REGISTRATION_REQUEST ? message.reg_req().id()
+                   : message.type() == PDU_SESSION_REQUEST ? message.pdu_req().id()
+                   : message.dereg_req().id();
+        request.request_id = static_cast<uint32_t>(trace.requests.size() + 1);
+        message.set_request_id(request.request_id);
+        switch (options.target) {
+            case TARGET_TCP:    message.AppendToString(&trace.wire); break;
+            case TARGET_FRAMED: append_frame(message, trace.wire); break;
+            case TARGET_HTTP:   append_http_request(message, host, trace.wire); break;
+        }
+        request.len = static_cast<uint32_t>(trace.wire.size() - request.offset);
+        if (!trace.requests.empty() && at_ns < static_cast<int64_t>(trace.requests.back().at_ns)) sorted = false;
+        trace.requests.push_back(request);
+    }
+
+    if (!sorted) {
+        // Merged traces may interleave; the wire bytes stay where they are
+        for (TraceRequest& request : trace.requests) request.at_ns -= static_cast<uint64_t>(earliest_ns);
+        std::stable_sort(trace.requests.begin(), trace.requests.end(),
+                         [](const TraceRequest& a, const TraceRequest& b) { return a.at_ns < b.at_ns; });
+    }
+    return true;
+}
+
+// Everything a replay thread shares
+struct ReplayPlan {
+    ReplayOptions options;
+    struct sockaddr_in address;
+    const Trace* trace;
+    uint64_t start_ns;   // Common time zero of all threads
+};
+
+// One request awaiting its reply
+struct ReplayRequest {
+    uint64_t start_ns;   // Scheduled (timed replay) or actual (--speed 0) send time
+    int slot;
+};
+
+struct ReplayConnection {
+    int fd = -1;
+    std::string out;
+    size_t out_offset = 0;
+    std::string in;
+    std::vector<uint32_t> queue;     // Trace indexes assigned to this connection, in order
+    size_t next = 0;                 // Next entry of 'queue' to send
+    std::unordered_map<uint64_t, ReplayRequest> in_flight;  // request_id -> request
+    std::deque<uint64_t> order;      // HTTP: request_ids in send order (replies come back in order)
+};
+
+// Results of one replay thread, merged after the run
+struct ReplayStats {
+    LatencyHistogram latency[3];        // Per request type
+    LatencyHistogram lag;               // Actual minus scheduled send time
+    uint64_t completed = 0;
+    uint64_t errors = 0;                // Failed connections or undecodable replies
+    uint64_t timed_out = 0;             // Unanswered or unsent when --timeout expired
+    std::map<int, uint64_t> statuses;   // Status code -> replies
+};
+
+// Function to open a non-blocking connection; completion is signalled by EPOLLOUT
+int replay_connect(const ReplayPlan& plan, int epoll_fd, ReplayConnection* conn) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (fd < 0) return -1;
+    int enable = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    if (connect(fd, (const struct sockaddr*)&plan.address, sizeof(plan.address)) < 0 && errno != EINPROGRESS) {
+        close(fd);
+        return -1;
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.ptr = conn;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        close(fd);
+        return -1;
+    }
+    conn->fd = fd;
+    return fd;
+}
+
+// Function to drop a connection; unanswered requests count as 'lost'
+void replay_disconnect(ReplayConnection& conn, uint64_t& lost) {
+    if (conn.fd >= 0) close(conn.fd);  // Also removes it from the epoll set
+    conn.fd = -1;
+    lost += conn.in_flight.size();
+    conn.in_flight.clear();
+    conn.order.clear();
+    conn.in.clear();
+    conn.out.clear();
+    conn.out_offset = 0;
+}
+
+// Function to write as much pending output as the socket accepts
+bool replay_flush(ReplayConnection& conn) {
+    while (conn.out_offset < conn.out.size()) {
+        ssize_t n = send(conn.fd, conn.out.data() + conn.out_offset, conn.out.size() - conn.out_offset, MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.out_offset += n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+    conn.out.clear();
+    conn.out_offset = 0;
+    return true;
+}
+
+bool replay_can_send(const ReplayPlan& plan, const ReplayConnection& conn) {
+    if (plan.options.target == TARGET_TCP) return conn.fd < 0;  // One connection per request
+    return static_cast<int>(conn.in_flight.size()) < plan.options.window;
+}
+
+// Function to queue trace request 'index' on a connection
+void replay_send(const ReplayPlan& plan, int epoll_fd, ReplayConnection& conn, ReplayStats& stats,
+                 uint32_t index, uint64_t start_ns) {
+    if (conn.fd < 0 && replay_connect(plan, epoll_fd, &conn) < 0) {
+        ++stats.errors;
+        return;
+    }
+    const TraceRequest& request = plan.trace->requests[index];
+    conn.out.append(plan.trace->wire, request.offset, request.len);
+    conn.in_flight[request.request_id] = ReplayRequest{start_ns, request.slot};
+    if (plan.options.target == TARGET_HTTP) conn.order.push_back(request.request_id);
+}
+
+// Function to record the reply to 'request_id' with status 'status'
+void replay_complete(ReplayConnection& conn, ReplayStats& stats, uint64_t request_id, int status, uint64_t now) {
+    auto it = conn.in_flight.find(request_id);
+    if (it == conn.in_flight.end()) {
+        ++stats.errors;
+        return;
+    }
+    stats.latency[it->second.slot].record(now - it->second.start_ns);
+    ++stats.statuses[status];
+    ++stats.completed;
+    conn.in_flight.erase(it);
+}
+
+// Function to measure one HTTP response at the start of 'in'. Returns its
+// length, 0 if it is incomplete or -1 if it cannot be parsed. 'status' is
+// the "status" field of a 200 response's JSON body, else the HTTP code.
+long parse_http_response(const std::string& in, int& status) {
+    size_t header_end = in.find("\r\n\r\n");
+    if (header_end == std::string::npos) return 0;
+    if (in.compare(0, 5, "HTTP/") != 0) return -1;
+    size_t code_pos = in.find(' ');
+    if (code_pos == std::string::npos || code_pos > header_end) return -1;
+    int code = std::atoi(in.c_str() + code_pos + 1);
+
+    long body_len = -1;
+    for (size_t line = in.find("\r\n") + 2; line < header_end; line = in.find("\r\n", line) + 2) {
+        if (strncasecmp(in.c_str() + line, "Content-Length:", 15) == 0) body_len = std::atol(in.c_str() + line + 15);
+    }
+    if (body_len < 0) return -1;  // Chunked replies are not used by serverAPI
+    size_t total = header_end + 4 + static_cast<size_t>(body_len);
+    if (in.size() < total) return 0;
+
+    status = code;
+    if (code == 200) {
+        std::string field;
+        if (json_field(in.substr(header_end + 4, body_len), "status", field)) status = std::atoi(field.c_str());
+    }
+    return static_cast<long>(total);
+}
+
+// Function to read and match every reply available on a connection.
+// Returns false if the connection has to be dropped.
+bool replay_receive(const ReplayPlan& plan, ReplayConnection& conn, ReplayStats& stats, ServerMessage& reply) {
+    char buffer[REPLAY_READ_CHUNK];
+    bool eof = false;
+    while (true) {
+        ssize_t n = recv(conn.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            conn.in.append(buffer, n);
+        } else if (n == 0) {
+            eof = true;
+            break;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    uint64_t now = monotonic_ns();
+
+    switch (plan.options.target) {
+        case TARGET_TCP: {
+            // The reply is complete once the server closes
+            if (!eof) return true;
+            if (!reply.ParseFromString(conn.in)) return false;
+            break;
+        }
+        case TARGET_FRAMED: {
+            size_t offset = 0;
+            const char* payload;
+            size_t len;
+            int frame;
+            while ((frame = next_frame(conn.in, offset, payload, len)) > 0) {
+                if (!reply.ParseFromArray(payload, static_cast<int>(len))) return false;
+                int status = reply.has_reg_ack() ? reply.reg_ack().status()
+                           : reply.has_pdu_ack() ? reply.pdu_ack().status()
+                           : reply.dereg_ack().status();
+                replay_complete(conn, stats, reply.request_id(), status, now);
+                offset += FRAME_HEADER_SIZE + len;
+            }
+            conn.in.erase(0, offset);
+            if (frame < 0) return false;
+            break;
+        }
+        case TARGET_HTTP: {
+            size_t offset = 0;
+            int status;
+            long len;
+            while (!conn.order.empty() && (len = parse_http_response(conn.in.substr(offset), status)) != 0) {
+                if (len < 0) return false;
+                replay_complete(conn, stats, conn.order.front(), status, now);
+                conn.order.pop_front();
+                offset += static_cast<size_t>(len);
+            }
+            conn.in.erase(0, offset);
+            break;
+        }
+    }
+
+    if (plan.options.target == TARGET_TCP) {
+        int status = reply.has_reg_ack() ? reply.reg_ack().status()
+                   : reply.has_pdu_ack() ? reply.pdu_ack().status()
+                   : reply.dereg_ack().status();
+        replay_complete(conn, stats, reply.request_id(), status, now);
+    }
+    // A keep-alive connection the server closed while idle is reopened on the next send
+    if (eof) replay_disconnect(conn, stats.errors);
+    return true;
+}
+
+// Function to send a connection's due requests while its window allows.
+// Lowers 'next_wakeup' to the next request's due time if it is still
+// ahead. Returns false if the connection failed while flushing.
+bool replay_fill(const ReplayPlan& plan, int epoll_fd, ReplayConnection& conn, ReplayStats& stats,
+                 uint64_t now, uint64_t& next_wakeup) {
+    bool timed = plan.options.speed > 0;
+    while (conn.next < conn.queue.size() && replay_can_send(plan, conn)) {
+        uint32_t index = conn.queue[conn.next];
+        uint64_t due = plan.start_ns;
+        if (timed) due += static_cast<uint64_t>(plan.trace->requests[index].at_ns / plan.options.speed);
+        if (due > now) {
+            next_wakeup = std::min(next_wakeup, due);
+            break;
+        }
+        if (timed) stats.lag.record(now - due);
+        replay_send(plan, epoll_fd, conn, stats, index, timed ? due : now);
+        ++conn.next;
+    }
+    return conn.fd < 0 || replay_flush(conn);
+}
+
+// Body of one replay thread: replays the requests of its own connections
+void replay_thread(const ReplayPlan& plan, std::vector<ReplayConnection>& connections, ReplayStats& stats) {
+    const ReplayOptions& options = plan.options;
+    ServerMessage reply;
+
+    int epoll_fd = epoll_create1(0);
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+    if (epoll_fd < 0 || timer_fd < 0) {
+        perror("replay setup failed");
+        return;
+    }
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;  // nullptr marks the timer
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev);
+
+    uint64_t progress = 0;               // Requests sent plus replies and errors seen
+    uint64_t progress_ns = plan.start_ns;  // When 'progress' last moved
+    std::vector<struct epoll_event> events(REPLAY_EVENTS);
+    while (true) {
+        uint64_t now = monotonic_ns();
+        uint64_t next_wakeup = UINT64_MAX;
+        bool all_sent = true;
+        bool all_answered = true;
+        uint64_t sent = 0;
+
+        // Send whatever is due and flush it
+        for (ReplayConnection& conn : connections) {
+            // A dropped connection frees its window, so fill it again
+            while (!replay_fill(plan, epoll_fd, conn, stats, now, next_wakeup)) replay_disconnect(conn, stats.errors);
+            if (conn.next < conn.queue.size()) all_sent = false;
+            if (!conn.in_flight.empty()) all_answered = false;
+            sent += conn.next;
+        }
+
+        if (all_sent && all_answered) break;
+        if (sent + stats.completed + stats.errors != progress) {
+            progress = sent + stats.completed + stats.errors;
+            progress_ns = now;
+        }
+        if (!all_answered) {
+            // The server has stalled
+            uint64_t deadline = progress_ns + uint64_t(options.timeout) * 1000000000ull;
+            if (now >= deadline) break;
+            next_wakeup = std::min(next_wakeup, deadline);
+        }
+
+        struct itimerspec timer = {};
+        if (next_wakeup != UINT64_MAX) {
+            timer.it_value.tv_sec = static_cast<time_t>(next_wakeup / 1000000000ull);
+            timer.it_value.tv_nsec = static_cast<long>(next_wakeup % 1000000000ull);
+        }
+        timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &timer, nullptr);
+
+        int n = epoll_wait(epoll_fd, events.data(), REPLAY_EVENTS, -1);
+        for (int i = 0; i < n; ++i) {
+            ReplayConnection* conn = static_cast<ReplayConnection*>(events[i].data.ptr);
+            if (conn == nullptr) {
+                uint64_t expirations;
+                (void)!read(timer_fd, &expirations, sizeof(expirations));
+                continue;
+            }
+            if (conn->fd < 0) continue;
+            bool ok = !(events[i].events & EPOLLERR);
+            if (ok && (events[i].events & EPOLLOUT)) ok = replay_flush(*conn);
+            if (ok && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))) ok = replay_receive(plan, *conn, stats, reply);
+            if (!ok) replay_disconnect(*conn, stats.errors);
+        }
+    }
+
+    for (ReplayConnection& conn : connections) {
+        stats.timed_out += conn.queue.size() - conn.next;
+        replay_disconnect(conn, stats.timed_out);
+    }
+    close(timer_fd);
+    close(epoll_fd);
+}
+
+// Function to replay a loaded trace and print throughput and latency percentiles
+void run_replay(const ReplayOptions& options, const Trace& trace) {
+    ReplayPlan plan;
+    plan.options = options;
+    plan.trace = &trace;
+    std::memset(&plan.address, 0, sizeof(plan.address));
+    plan.address.sin_family = AF_INET;
+    plan.address.sin_port = htons(options.port);
+    if (inet_pton(AF_INET, options.server_ip.c_str(), &plan.address.sin_addr) <= 0) {
+        std::cerr << "Invalid address" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Requests of one subscriber share a connection, so their order is kept
+    size_t lanes = static_cast<size_t>(options.threads) * options.connections;
+    std::vector<std::vector<ReplayConnection>> connections(options.threads);
+    for (auto& c : connections) c.resize(options.connections);
+    for (uint32_t i = 0; i < trace.requests.size(); ++i) {
+        size_t lane = static_cast<uint32_t>(trace.requests[i].id) % lanes;
+        connections[lane / options.connections][lane % options.connections].queue.push_back(i);
+    }
+
+    static const char* const target_names[] = {"one connection per request", "framed", "HTTP"};
+    double span = trace.requests.empty() ? 0 : trace.requests.back().at_ns / 1e9;
+    char timing[64];
+    if (options.speed > 0) {
+        snprintf(timing, sizeof(timing), "%.3f s at speed %g", span / options.speed, options.speed);
+    } else {
+        snprintf(timing, sizeof(timing), "as fast as possible");
+    }
+    std::cout << "Replay: " << trace.requests.size() << " requests (" << trace.wire.size() << " wire bytes), "
+              << target_names[options.target] << ", " << options.threads << " thread(s) x "
+              << options.connections << " connection(s), window " << options.window << ", " << timing << std::endl;
+
+    std::vector<std::unique_ptr<ReplayStats>> stats;
+    std::vector<std::thread> threads;
+    plan.start_ns = monotonic_ns();
+    for (int i = 0; i < options.threads; ++i) {
+        stats.emplace_back(new ReplayStats());
+        threads.emplace_back(replay_thread, std::cref(plan), std::ref(connections[i]), std::ref(*stats.back()));
+    }
+    for (auto& t : threads) t.join();
+    double elapsed = (monotonic_ns() - plan.start_ns) / 1e9;
+
+    uint64_t completed = 0, errors = 0, timed_out = 0;
+    std::map<int, uint64_t> statuses;
+    for (const auto& s : stats) {
+        completed += s->completed;
+        errors += s->errors;
+        timed_out += s->timed_out;
+        for (const auto& entry : s->statuses) statuses[entry.first] += entry.second;
+    }
+
+    printf("Requests: %llu completed, %llu errors, %llu timed out, %.3f s, %.1f req/s\n",
+           static_cast<unsigned long long>(completed), static_cast<unsigned long long>(errors),
+           static_cast<unsigned long long>(timed_out), elapsed, completed / elapsed);
+    std::string out = "Status:";
+    for (const auto& entry : statuses) out += " " + std::to_string(entry.first) + "=" + std::to_string(entry.second);
+    out += "\n";
+    out += LATENCY_HEADER;
+
+    static const char* const slot_names[] = {"REGISTRATION_REQUEST", "PDU_SESSION_REQUEST", "DEREGISTRATION_REQUEST"};
+    std::unique_ptr<HistogramSnapshot> all(new HistogramSnapshot());
+    for (int slot = 0; slot < 3; ++slot) {
+        std::unique_ptr<HistogramSnapshot> snapshot(new HistogramSnapshot());
+        for (const auto& s : stats) {
+            s->latency[slot].add_to(*snapshot);
+            s->latency[slot].add_to(*all);
+        }
+        if (snapshot->count > 0) append_latency_line(out, slot_names[slot], *snapshot);
+    }
+    append_latency_line(out, "all", *all);
+    if (options.speed > 0) {
+        std::unique_ptr<HistogramSnapshot> lag(new HistogramSnapshot());
+        for (const auto& s : stats) s->lag.add_to(*lag);
+        append_latency_line(out, "send lag behind schedule", *lag);
+    }
+    std::cout << out << std::flush;
+}
+
+// Parse command-line arguments
+void parse_arguments(int argc, char* argv[], ReplayOptions& options) {
+    static const struct option long_options[] = {
+        {"http",        no_argument,       nullptr, 'H'},
+        {"threads",     required_argument, nullptr, 'T'},
+        {"connections", required_argument, nullptr, 'C'},
+        {"speed",       required_argument, nullptr, 'S'},
+        {"timeout",     required_argument, nullptr, 'O'},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    int option;
+    while ((option = getopt_long(argc, argv, "h:p:fw:HT:C:S:O:", long_options, nullptr)) != -1) {
+        switch (option) {
+            case 'h':
+                options.server_ip = optarg;
+                break;
+            case 'p':
+                options.port = std::stoi(optarg);
+                break;
+            case 'f':
+                options.target = TARGET_FRAMED;
+                break;
+            case 'w':
+                options.window = std::max(1, std::stoi(optarg));
+                break;
+            case 'H':
+                options.target = TARGET_HTTP;
+                break;
+            case 'T':
+                options.threads = std::max(1, std::stoi(optarg));
+                break;
+            case 'C':
+                options.connections = std::max(1, std::stoi(optarg));
+                break;
+            case 'S':
+                options.speed = std::max(0.0, std::stod(optarg));
+                break;
+            case 'O':
+                options.timeout = std::max(0, std::stoi(optarg));
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [-h server_ip] [-p port] [-f | --http] [-w window]"
+                          << " [--threads N] [--connections N] [--speed factor] [--timeout seconds] [trace.jsonl]"
+                          << std::endl;
+                exit(EXIT_FAILURE);
+        }
+    }
+    if (optind < argc) options.path = argv[optind];
+}
+
+int main(int argc, char* argv[]) {
+    GOOGLE_PROTOBUF_VERIFY_VERSION;
+
+    ReplayOptions options;
+    parse_arguments(argc, argv, options);
+
+    std::unique_ptr<Trace> trace(new Trace());
+    if (!load_trace(options, *trace)) return EXIT_FAILURE;
+    run_replay(options, *trace);
+
+    google::protobuf::ShutdownProtobufLibrary();
+    return 0;
+}
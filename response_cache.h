@@ -0,0 +1,198 @@
+// Pre-encoded ServerMessage acks. Every ack carries one of a fixed set of
+// (type, status, status_message) combinations, so each one is serialized once
+// at startup and a reply only splices in its varint id/pdu_id/request_id
+// fields. The output is byte-for-byte what ServerMessage::SerializeToString()
+// would produce, without building or serializing a message per request.
+#ifndef RESPONSE_CACHE_H
+#define RESPONSE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "message.pb.h"
+#include "subscriber_core.h"
+
+// One reply as decided by the request handler
+struct Ack {
+    AckKind kind;
+    int32_t id;
+    int32_t pdu_id;       // 0 unless a PDU session was established
+    uint64_t request_id;
+};
+
+class ResponseCache {
+public:
+    // Serializes the constant part of every ack; call once before serving
+    void init() {
+        // Status and message come from the core (subscriber_core.h)
+        struct Definition { AckKind kind; MessageType type; };
+        static const Definition definitions[] = {
+            {REG_SUCCESSFUL,         REGISTRATION_ACK},
+            {REG_ALREADY_REGISTERED, REGISTRATION_ACK},
+            {PDU_INVALID_SST,        PDU_SESSION_ACK},
+            {PDU_INVALID_SD,         PDU_SESSION_ACK},
+            {PDU_NOT_REGISTERED,     PDU_SESSION_ACK},
+            {PDU_ESTABLISHED,        PDU_SESSION_ACK},
+            {PDU_NO_FREE_ID,         PDU_SESSION_ACK},
+            {DEREG_SUCCESSFUL,       DEREGISTRATION_ACK},
+            {DEREG_NOT_FOUND,        DEREGISTRATION_ACK},
+        };
+
+        for (const Definition& d : definitions) {
+            Template& t = templates_[d.kind];
+            const AckDefinition& ack_def = ack_definition(d.kind);
+            t.type = static_cast<uint8_t>(d.type);
+            t.status = ack_def.status;
+            // With id and pdu_id left at 0 only the constant fields are encoded.
+            // They have the highest field numbers, so the per-request fields
+            // are written in front of them.
+            switch (d.type) {
+                case REGISTRATION_ACK: {
+                    RegistrationAck ack;
+                    ack.set_status(ack_def.status);
+                    ack.set_status_message(ack_def.message);
+                    ack.SerializeToString(&t.fields);
+                    t.tag = tag(ServerMessage::kRegAckFieldNumber, WIRE_LENGTH);
+                    break;
+                }
+                case PDU_SESSION_ACK: {
+                    PduSessionAck ack;
+                    ack.set_status(ack_def.status);
+                    ack.set_status_message(ack_def.message);
+                    ack.SerializeToString(&t.fields);
+                    t.tag = tag(ServerMessage::kPduAckFieldNumber, WIRE_LENGTH);
+                    break;
+                }
+                default: {
+                    DeregistrationAck ack;
+                    ack.set_status(ack_def.status);
+                    ack.set_status_message(ack_def.message);
+                    ack.SerializeToString(&t.fields);
+                    t.tag = tag(ServerMessage::kDeregAckFieldNumber, WIRE_LENGTH);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Status code carried by acks of 'kind'
+    int status(AckKind kind) const { return templates_[kind].status; }
+
+    // Encoded size of 'ack' as a ServerMessage
+    size_t encoded_size(const Ack& ack) const {
+        size_t body = body_size(ack);
+        return 2 + 1 + varint_size(body) + body + request_id_size(ack.request_id);
+    }
+
+    // Appends 'ack' to 'out' as an encoded ServerMessage
+    void append(const Ack& ack, std::string& out) const {
+        size_t offset = out.size();
+        out.resize(offset + encoded_size(ack));
+        char* p = write_ack(&out[offset], ack);
+        write_request_id(p, ack.request_id);
+    }
+
+    // Appends 'count' acks to 'out' as one BATCH_ACK ServerMessage
+    void append_batch(const Ack* acks, size_t count, uint64_t request_id, std::string& out) const {
+        size_t items = 0;
+        for (size_t i = 0; i < count; ++i) {
+            size_t item = encoded_size(acks[i]);
+            items += 1 + varint_size(item) + item;
+        }
+
+        size_t offset = out.size();
+        out.resize(offset + 2 + request_id_size(request_id) + 1 + varint_size(items) + items);
+        char* p = &out[offset];
+        p = write_type(p, BATCH_ACK);
+        p = write_request_id(p, request_id);
+        *p++ = static_cast<char>(tag(ServerMessage::kBatchFieldNumber, WIRE_LENGTH));
+        p = write_varint(p, items);
+        for (size_t i = 0; i < count; ++i) {
+            *p++ = static_cast<char>(tag(ServerBatch::kMessagesFieldNumber, WIRE_LENGTH));
+            p = write_varint(p, encoded_size(acks[i]));
+            p = write_ack(p, acks[i]);
+            p = write_request_id(p, acks[i].request_id);
+        }
+    }
+
+private:
+    enum { WIRE_VARINT = 0, WIRE_LENGTH = 2 };
+
+    struct Template {
+        uint8_t type = 0;       // MessageType of the ack
+        uint8_t tag = 0;        // ServerMessage field tag of the ack submessage
+        int status = 0;
+        std::string fields;     // Encoded status and status_message
+    };
+
+    static uint8_t tag(int field, int wire_type) { return static_cast<uint8_t>(field << 3 | wire_type); }
+
+    // int32 fields are encoded as sign-extended 64-bit varints
+    static uint64_t int32_varint(int32_t value) { return static_cast<uint64_t>(static_cast<int64_t>(value)); }
+
+    static size_t varint_size(uint64_t value) {
+        size_t size = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            ++size;
+        }
+        return size;
+    }
+
+    static char* write_varint(char* p, uint64_t value) {
+        while (value >= 0x80) {
+            *p++ = static_cast<char>(value | 0x80);
+            value >>= 7;
+        }
+        *p++ = static_cast<char>(value);
+        return p;
+    }
+
+    static size_t request_id_size(uint64_t request_id) {
+        return request_id == 0 ? 0 : 1 + varint_size(request_id);
+    }
+
+    size_t body_size(const Ack& ack) const {
+        size_t size = templates_[ack.kind].fields.size();
+        if (ack.id != 0) size += 1 + varint_size(int32_varint(ack.id));
+        if (ack.pdu_id != 0) size += 1 + varint_size(int32_varint(ack.pdu_id));
+        return size;
+    }
+
+    static char* write_type(char* p, MessageType type) {
+        *p++ = static_cast<char>(tag(ServerMessage::kTypeFieldNumber, WIRE_VARINT));
+        *p++ = static_cast<char>(type);  // Every MessageType fits in one byte
+        return p;
+    }
+
+    // Fields are written in field-number order, as protobuf does: type, ack, request_id
+    char* write_ack(char* p, const Ack& ack) const {
+        const Template& t = templates_[ack.kind];
+        p = write_type(p, static_cast<MessageType>(t.type));
+        *p++ = static_cast<char>(t.tag);
+        p = write_varint(p, body_size(ack));
+        if (ack.id != 0) {
+            *p++ = static_cast<char>(tag(1, WIRE_VARINT));  // id = 1 in every ack
+            p = write_varint(p, int32_varint(ack.id));
+        }
+        if (ack.pdu_id != 0) {
+            *p++ = static_cast<char>(tag(PduSessionAck::kPduIdFieldNumber, WIRE_VARINT));
+            p = write_varint(p, int32_varint(ack.pdu_id));
+        }
+        std::memcpy(p, t.fields.data(), t.fields.size());
+        return p + t.fields.size();
+    }
+
+    static char* write_request_id(char* p, uint64_t request_id) {
+        if (request_id == 0) return p;
+        *p++ = static_cast<char>(tag(ServerMessage::kRequestIdFieldNumber, WIRE_VARINT));
+        return write_varint(p, request_id);
+    }
+
+    Template templates_[ACK_KIND_COUNT];
+};
+
+extern ResponseCache response_cache;  // Defined by each binary that sends protobuf acks
+
+#endif // RESPONSE_CACHE_H
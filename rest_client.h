@@ -0,0 +1,181 @@
+// Long-lived libcurl client for the REST server. Handles, the header lists and
+// the multi handle are created once and reused, so keep-alive connections
+// survive between requests instead of costing a TCP handshake each.
+//  - send():      one blocking request on a reused easy handle
+//  - sendBatch(): many requests at once through the curl multi interface,
+//                 at most 'concurrency' in flight over a pool of handles
+//                 (and so of connections) that is kept between batches
+// Call curl_global_init() before creating a client.
+#ifndef REST_CLIENT_H
+#define REST_CLIENT_H
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include <curl/curl.h>
+
+struct RestRequest {
+    bool isDelete = false;     // DELETE, otherwise POST
+    std::string path;          // e.g. "/register"
+    std::string body;          // JSON, or an encoded ClientMessage if protobuf
+    bool protobuf = false;     // Send as application/x-protobuf and ask for a protobuf reply
+};
+
+struct RestResponse {
+    long code = 0;             // HTTP status, 0 if the transfer failed
+    std::string body;
+    std::string error;         // curl error if the transfer failed
+    double seconds = 0;        // Time from start of the transfer to completion
+};
+
+class RestClient {
+public:
+    explicit RestClient(const std::string& baseUrl) : baseUrl(baseUrl) {
+        headers = curl_slist_append(nullptr, "Content-Type: application/json");
+        protobufHeaders = curl_slist_append(nullptr, "Content-Type: application/x-protobuf");
+        protobufHeaders = curl_slist_append(protobufHeaders, "Accept: application/x-protobuf");
+        easy = newHandle();
+        multi = curl_multi_init();
+    }
+
+    ~RestClient() {
+        for (Transfer& t : pool) {
+            curl_easy_cleanup(t.handle);
+        }
+        if (multi) curl_multi_cleanup(multi);
+        if (easy) curl_easy_cleanup(easy);
+        curl_slist_free_all(headers);
+        curl_slist_free_all(protobufHeaders);
+    }
+
+    RestClient(const RestClient&) = delete;
+    RestClient& operator=(const RestClient&) = delete;
+
+    // Function to send one request and wait for the response
+    RestResponse send(const RestRequest& request) {
+        RestResponse response;
+        prepare(easy, request, response);
+        auto start = std::chrono::steady_clock::now();
+        CURLcode res = curl_easy_perform(easy);
+        finish(easy, res, response, start);
+        return response;
+    }
+
+    // Function to run 'requests' with up to 'concurrency' in flight.
+    // onDone(index, response) is called as each one completes.
+    void sendBatch(const std::vector<RestRequest>& requests, size_t concurrency,
+                   const std::function<void(size_t, RestResponse&)>& onDone) {
+        if (concurrency == 0) concurrency = 1;
+        while (pool.size() < concurrency) {
+            pool.emplace_back();
+            pool.back().handle = newHandle();
+        }
+        // Growing the pool may have moved it: (re)point every handle at its Transfer
+        for (Transfer& t : pool) {
+            curl_easy_setopt(t.handle, CURLOPT_PRIVATE, static_cast<void*>(&t));
+        }
+        curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(concurrency));
+        curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, static_cast<long>(concurrency));
+
+        std::vector<Transfer*> idle;
+        for (size_t i = 0; i < concurrency; ++i) {
+            idle.push_back(&pool[i]);
+        }
+        size_t next = 0;
+        size_t active = 0;
+        while (next < requests.size() || active > 0) {
+            while (!idle.empty() && next < requests.size()) {
+                Transfer* t = idle.back();
+                idle.pop_back();
+                t->index = next;
+                t->response = RestResponse();
+                prepare(t->handle, requests[next], t->response);
+                t->start = std::chrono::steady_clock::now();
+                curl_multi_add_handle(multi, t->handle);
+                ++next;
+                ++active;
+            }
+
+            int running = 0;
+            curl_multi_perform(multi, &running);
+            int queued = 0;
+            while (CURLMsg* msg = curl_multi_info_read(multi, &queued)) {
+                if (msg->msg != CURLMSG_DONE) continue;
+                Transfer* t = nullptr;
+                curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&t));
+                CURLcode res = msg->data.result;
+                curl_multi_remove_handle(multi, t->handle);
+                finish(t->handle, res, t->response, t->start);
+                --active;
+                idle.push_back(t);
+                onDone(t->index, t->response);
+            }
+            // Wait for socket activity unless a freed handle can start the next request
+            if (active > 0 && (idle.empty() || next == requests.size())) {
+                curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+            }
+        }
+    }
+
+    // Function to run 'requests' concurrently and return the responses in order
+    std::vector<RestResponse> sendBatch(const std::vector<RestRequest>& requests, size_t concurrency) {
+        std::vector<RestResponse> responses(requests.size());
+        sendBatch(requests, concurrency, [&](size_t index, RestResponse& response) {
+            responses[index] = std::move(response);
+        });
+        return responses;
+    }
+
+private:
+    struct Transfer {
+        CURL* handle = nullptr;
+        size_t index = 0;
+        RestResponse response;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    std::string baseUrl;
+    struct curl_slist* headers = nullptr;
+    struct curl_slist* protobufHeaders = nullptr;
+    CURL* easy = nullptr;            // For send()
+    CURLM* multi = nullptr;          // For sendBatch(); owns the pooled connections
+    std::vector<Transfer> pool;      // Handles for sendBatch(), reused across batches
+
+    static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+        static_cast<std::string*>(userp)->append(static_cast<char*>(contents), size * nmemb);
+        return size * nmemb;
+    }
+
+    // Options that stay the same for every request on a handle
+    CURL* newHandle() {
+        CURL* handle = curl_easy_init();
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, writeCallback);
+        curl_easy_setopt(handle, CURLOPT_TCP_NODELAY, 1L);
+        curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L);
+        return handle;
+    }
+
+    void prepare(CURL* handle, const RestRequest& request, RestResponse& response) {
+        std::string url = baseUrl + request.path;
+        curl_easy_setopt(handle, CURLOPT_URL, url.c_str());  // curl copies the string
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, request.protobuf ? protobufHeaders : headers);
+        curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, request.isDelete ? "DELETE" : nullptr);
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDS, request.body.data());
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, static_cast<long>(request.body.size()));
+        curl_easy_setopt(handle, CURLOPT_WRITEDATA, &response.body);
+    }
+
+    static void finish(CURL* handle, CURLcode res, RestResponse& response,
+                       std::chrono::steady_clock::time_point start) {
+        response.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (res == CURLE_OK) {
+            curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response.code);
+        } else {
+            response.code = 0;
+            response.error = curl_easy_strerror(res);
+        }
+    }
+};
+
+#endif // REST_CLIENT_H
@@ -0,0 +1,268 @@
+// Fast path for the REST server's JSON. Request bodies are tiny flat objects
+// ({"id":5} or {"id":5,"sst":1,"sd":"0101"}), so scanRequest() reads them in
+// place with no allocation instead of building a nlohmann DOM. It only
+// accepts input it fully understands (the keys id/sst/sd, each at most once,
+// plain integers up to 9 digits, an ASCII sd without escapes); for anything
+// else it returns false and the caller falls back to the generic parser,
+// which keeps the old behaviour for unusual or invalid bodies. scanBatch()
+// does the same for the bulk endpoints' {"ids":[...]} / {"from":a,"to":b}
+// bodies, and formatBatchReply() writes their per-item results.
+// Replies are formatted once from the core's ack definitions
+// (subscriber_core.h), byte-for-byte what json::dump() produced (keys in
+// sorted order), so nothing is built or serialized per request.
+#ifndef REST_JSON_H
+#define REST_JSON_H
+
+#include <array>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "subscriber_core.h"
+
+#define REST_FIELD_ID  1u
+#define REST_FIELD_SST 2u
+#define REST_FIELD_SD  4u
+#define REST_FIELD_IDS  8u
+#define REST_FIELD_FROM 16u
+#define REST_FIELD_TO   32u
+
+struct RestFields {
+    unsigned present = 0;      // REST_FIELD_* bits of the keys found
+    int id = 0;
+    int sst = 0;
+    std::string_view sd;       // Points into the body, or into sdStorage
+    std::string sdStorage;     // Owns sd when it came from the generic parser
+};
+
+// Body of a bulk request: an "ids" array or an inclusive "from"/"to" range,
+// plus the "sst"/"sd" of every session for /pdu-session/batch
+struct RestBatch {
+    unsigned present = 0;      // REST_FIELD_* bits of the keys found
+    std::vector<int> ids;      // Capacity is kept when the batch is reused
+    int from = 0;
+    int to = 0;
+    int sst = 0;
+    std::string_view sd;
+    std::string sdStorage;
+};
+
+namespace restjson {
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline void skipSpace(const char*& p, const char* end) {
+    while (p < end && isSpace(*p)) ++p;
+}
+
+// JSON integer -?(0|[1-9][0-9]*) that fits an int without overflow checks
+inline bool scanInt(const char*& p, const char* end, int& value) {
+    bool negative = false;
+    if (p < end && *p == '-') {
+        negative = true;
+        ++p;
+    }
+    const char* start = p;
+    int result = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        result = result * 10 + (*p - '0');
+        ++p;
+    }
+    size_t digits = static_cast<size_t>(p - start);
+    if (digits == 0 || digits > 9) return false;
+    if (*start == '0' && digits > 1) return false;                     // Leading zero
+    if (p < end && (*p == '.' || *p == 'e' || *p == 'E')) return false;  // Not an integer
+    value = negative ? -result : result;
+    return true;
+}
+
+// String without escapes, control characters or non-ASCII bytes; p is past the opening quote
+inline bool scanString(const char*& p, const char* end, std::string_view& value) {
+    const char* start = p;
+    while (p < end && *p != '"') {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '\\' || c < 0x20 || c >= 0x80) return false;
+        ++p;
+    }
+    if (p == end) return false;
+    value = std::string_view(start, static_cast<size_t>(p - start));
+    ++p;
+    return true;
+}
+
+// [int, int, ...] of JSON integers as accepted by scanInt()
+inline bool scanIntArray(const char*& p, const char* end, std::vector<int>& values) {
+    values.clear();
+    if (p == end || *p != '[') return false;
+    ++p;
+    skipSpace(p, end);
+    if (p < end && *p == ']') {
+        ++p;
+        return true;
+    }
+    while (true) {
+        int value;
+        if (!scanInt(p, end, value)) return false;
+        values.push_back(value);
+        skipSpace(p, end);
+        if (p == end) return false;
+        if (*p == ']') {
+            ++p;
+            return true;
+        }
+        if (*p != ',') return false;
+        ++p;
+        skipSpace(p, end);
+    }
+}
+
+// Function to walk a flat JSON object. scanValue(key, p, end) reads the value
+// of each key and returns false for a key or value it does not accept.
+template <typename ScanValue>
+inline bool scanObject(std::string_view body, ScanValue scanValue) {
+    const char* p = body.data();
+    const char* end = p + body.size();
+
+    skipSpace(p, end);
+    if (p == end || *p != '{') return false;
+    ++p;
+    skipSpace(p, end);
+    if (p < end && *p == '}') {
+        ++p;
+    } else {
+        while (true) {
+            std::string_view key;
+            if (p == end || *p != '"') return false;
+            ++p;
+            if (!scanString(p, end, key)) return false;
+            skipSpace(p, end);
+            if (p == end || *p != ':') return false;
+            ++p;
+            skipSpace(p, end);
+            if (!scanValue(key, p, end)) return false;
+
+            skipSpace(p, end);
+            if (p == end) return false;
+            if (*p == '}') {
+                ++p;
+                break;
+            }
+            if (*p != ',') return false;
+            ++p;
+            skipSpace(p, end);
+        }
+    }
+    skipSpace(p, end);
+    return p == end;
+}
+
+// Function to record a key in 'present'; duplicate keys go to the generic parser
+inline bool firstUse(unsigned& present, unsigned field) {
+    if (present & field) return false;
+    present |= field;
+    return true;
+}
+
+// Function to read an sd string value
+inline bool scanSd(const char*& p, const char* end, std::string_view& sd) {
+    if (p == end || *p != '"') return false;
+    ++p;
+    return scanString(p, end, sd);
+}
+
+} // namespace restjson
+
+// Function to read a request body in place. Returns false if the body is not
+// a flat object of known keys; 'fields' is then unspecified.
+inline bool scanRequest(std::string_view body, RestFields& fields) {
+    using namespace restjson;
+    fields.present = 0;
+    return scanObject(body, [&](std::string_view key, const char*& p, const char* end) {
+        if (key == "id") return firstUse(fields.present, REST_FIELD_ID) && scanInt(p, end, fields.id);
+        if (key == "sst") return firstUse(fields.present, REST_FIELD_SST) && scanInt(p, end, fields.sst);
+        if (key == "sd") return firstUse(fields.present, REST_FIELD_SD) && scanSd(p, end, fields.sd);
+        return false;
+    });
+}
+
+// Function to read a bulk request body in place, like scanRequest()
+inline bool scanBatch(std::string_view body, RestBatch& batch) {
+    using namespace restjson;
+    batch.present = 0;
+    return scanObject(body, [&](std::string_view key, const char*& p, const char* end) {
+        if (key == "ids") return firstUse(batch.present, REST_FIELD_IDS) && scanIntArray(p, end, batch.ids);
+        if (key == "from") return firstUse(batch.present, REST_FIELD_FROM) && scanInt(p, end, batch.from);
+        if (key == "to") return firstUse(batch.present, REST_FIELD_TO) && scanInt(p, end, batch.to);
+        if (key == "sst") return firstUse(batch.present, REST_FIELD_SST) && scanInt(p, end, batch.sst);
+        if (key == "sd") return firstUse(batch.present, REST_FIELD_SD) && scanSd(p, end, batch.sd);
+        return false;
+    });
+}
+
+// Function to get the JSON body of an ack (any kind but PDU_ESTABLISHED)
+inline const std::string& restReply(AckKind kind) {
+    static const auto replies = [] {
+        std::array<std::string, ACK_KIND_COUNT> table;
+        for (int i = 0; i < ACK_KIND_COUNT; ++i) {
+            const AckDefinition& d = ack_definition(static_cast<AckKind>(i));
+            table[i] = std::string(R"({"message":")") + d.message + R"(","status":)" + std::to_string(d.status) + "}";
+        }
+        return table;
+    }();
+    return replies[kind];
+}
+
+// Function to get the JSON body of a "PDU Session Established" reply (pdu_id 1-15)
+inline const std::string& restPduEstablished(int pduId) {
+    static const auto replies = [] {
+        std::array<std::string, MAX_PDU_SESSIONS + 1> table;
+        for (int i = 1; i <= MAX_PDU_SESSIONS; ++i) {
+            table[i] = std::string(R"({"message":")") + ack_definition(PDU_ESTABLISHED).message +
+                       R"(","pdu_id":)" + std::to_string(i) + R"(,"status":200})";
+        }
+        return table;
+    }();
+    return replies[pduId];
+}
+
+// Function to write a bulk reply: the item count, how many succeeded (status
+// 200) and the status of every item in request order, plus each item's PDU
+// ID (0 if none) when 'pduIds' is given:
+//   {"count":3,"succeeded":2,"statuses":[200,400,200],"pdu_ids":[1,0,2]}
+inline void formatBatchReply(const AckKind* kinds, const int* pduIds, size_t count, std::string& out) {
+    size_t succeeded = 0;
+    for (size_t i = 0; i < count; ++i) {
+        succeeded += ack_definition(kinds[i]).status == 200;
+    }
+    out.clear();
+    out.reserve(64 + count * (pduIds ? 7 : 4));
+    char digits[16];
+    auto appendNumber = [&](long long value) {
+        char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        out.append(digits, static_cast<size_t>(end - digits));
+    };
+
+    out += R"({"count":)";
+    appendNumber(static_cast<long long>(count));
+    out += R"(,"succeeded":)";
+    appendNumber(static_cast<long long>(succeeded));
+    out += R"(,"statuses":[)";
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) out += ',';
+        appendNumber(ack_definition(kinds[i]).status);
+    }
+    out += ']';
+    if (pduIds != nullptr) {
+        out += R"(,"pdu_ids":[)";
+        for (size_t i = 0; i < count; ++i) {
+            if (i > 0) out += ',';
+            appendNumber(pduIds[i]);
+        }
+        out += ']';
+    }
+    out += '}';
+}
+
+#endif // REST_JSON_H
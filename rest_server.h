@@ -0,0 +1,376 @@
+// REST front-end: a Pistache endpoint serving /register, /pdu-session and
+// /deregister on the shared core (subscriber_core.h). Bodies are JSON, read
+// in place by rest_json.h, or protobuf ClientMessages (Content-Type:
+// application/x-protobuf); replies are JSON, or the pre-encoded ServerMessage
+// acks of response_cache.h when the Accept header asks for protobuf.
+// serverAPI.cpp runs it on its own and combinedServer.cpp next to the TCP
+// front-end.
+// The /register/batch, /pdu-session/batch and /deregister/batch endpoints take
+// many IDs in one JSON body, {"ids":[...]} or the inclusive range
+// {"from":a,"to":b}, apply them in one call to the core and reply with every
+// item's status in request order (formatBatchReply() in rest_json.h).
+// With a write-ahead log a reply is handed to the log and sent by its flusher
+// once the request's changes are durable; the worker moves on meanwhile.
+#ifndef REST_SERVER_H
+#define REST_SERVER_H
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <sched.h>
+#include <pistache/endpoint.h>
+#include <pistache/router.h>
+#include <pistache/http.h>
+#include <nlohmann/json.hpp>
+#include "subscriber_core.h"
+#include "response_cache.h"
+#include "rest_json.h"
+#include "logger.h"
+#include "message.pb.h"
+
+namespace Http = Pistache::Http;
+namespace Rest = Pistache::Rest;
+using json = nlohmann::json;
+
+#define REST_DEFAULT_PORT 8081
+#define WORKER_THREAD_NAME "api-worker"   // Name of the Pistache reactor threads (max 15 characters)
+#define PROTOBUF_MIME "application/x-protobuf"
+#define REST_MAX_BATCH (1 << 20)          // Most IDs one batch request may name
+
+// Log formats of one endpoint. A log record keeps a single string argument,
+// so the endpoint's name is part of each literal and the parser's reason is
+// the string passed.
+struct RestEndpointLog {
+    const char* badProtobuf;
+    const char* badJson;       // {} = reason
+    const char* badBatchJson;  // {} = reason
+    const char* badBatch;      // {} = REST_MAX_BATCH
+};
+
+inline constexpr RestEndpointLog registrationLog{
+    "Error parsing registration request: invalid protobuf message",
+    "Error parsing registration request: {}",
+    "Error parsing registration batch request: {}",
+    "Error parsing registration batch request: expected \"ids\" or \"from\" <= \"to\", at most {} IDs"};
+inline constexpr RestEndpointLog pduSessionLog{
+    "Error parsing PDU session request: invalid protobuf message",
+    "Error parsing PDU session request: {}",
+    "Error parsing PDU session batch request: {}",
+    "Error parsing PDU session batch request: expected \"ids\" or \"from\" <= \"to\", at most {} IDs"};
+inline constexpr RestEndpointLog deregistrationLog{
+    "Error parsing deregistration request: invalid protobuf message",
+    "Error parsing deregistration request: {}",
+    "Error parsing deregistration batch request: {}",
+    "Error parsing deregistration batch request: expected \"ids\" or \"from\" <= \"to\", at most {} IDs"};
+
+class ServerAPI {
+public:
+    explicit ServerAPI(Pistache::Address addr) : httpEndpoint(std::make_shared<Http::Endpoint>(addr)) {}
+
+    // maxRequestSize 0 keeps Pistache's default
+    void init(size_t thr, size_t maxRequestSize) {
+        auto opts = Http::Endpoint::options()
+                        .threads(static_cast<int>(thr))
+                        .threadsName(WORKER_THREAD_NAME)
+                        .flags(Pistache::Tcp::Options::ReuseAddr);
+        if (maxRequestSize > 0) opts.maxRequestSize(maxRequestSize);
+        httpEndpoint->init(opts);
+        setupRoutes();
+    }
+
+    void start() {
+        httpEndpoint->setHandler(router.handler());
+        httpEndpoint->serve();
+    }
+
+private:
+    std::shared_ptr<Http::Endpoint> httpEndpoint;
+    Rest::Router router;
+
+    void setupRoutes() {
+        Rest::Routes::Post(router, "/register", Rest::Routes::bind(&ServerAPI::registerUser, this));
+        Rest::Routes::Post(router, "/pdu-session", Rest::Routes::bind(&ServerAPI::pduSession, this));
+        Rest::Routes::Delete(router, "/deregister", Rest::Routes::bind(&ServerAPI::deregisterUser, this));
+        Rest::Routes::Post(router, "/register/batch", Rest::Routes::bind(&ServerAPI::registerBatch, this));
+        Rest::Routes::Post(router, "/pdu-session/batch", Rest::Routes::bind(&ServerAPI::pduSessionBatch, this));
+        Rest::Routes::Delete(router, "/deregister/batch", Rest::Routes::bind(&ServerAPI::deregisterBatch, this));
+    }
+
+    // Function to read the request fields: in place when the body is one of the
+    // known shapes, otherwise with nlohmann::json, which throws on invalid input
+    static void readFields(const std::string& body, unsigned required, RestFields& fields) {
+        if (scanRequest(body, fields) && (fields.present & required) == required) return;
+        auto parsed = json::parse(body);
+        fields.id = parsed.at("id");
+        if (required & REST_FIELD_SST) fields.sst = parsed.at("sst");
+        if (required & REST_FIELD_SD) {
+            fields.sdStorage = parsed.at("sd").get<std::string>();
+            fields.sd = fields.sdStorage;
+        }
+    }
+
+    // Function to read a batch body like readFields(); a range is left in from/to
+    static void readBatchFields(const std::string& body, unsigned required, RestBatch& batch) {
+        if (scanBatch(body, batch) && (batch.present & required) == required) return;
+        auto parsed = json::parse(body);
+        batch.present = 0;
+        if (parsed.contains("ids")) {
+            batch.ids = parsed.at("ids").get<std::vector<int>>();
+            batch.present |= REST_FIELD_IDS;
+        }
+        if (parsed.contains("from")) {
+            batch.from = parsed.at("from");
+            batch.present |= REST_FIELD_FROM;
+        }
+        if (parsed.contains("to")) {
+            batch.to = parsed.at("to");
+            batch.present |= REST_FIELD_TO;
+        }
+        if (required & REST_FIELD_SST) batch.sst = parsed.at("sst");
+        if (required & REST_FIELD_SD) {
+            batch.sdStorage = parsed.at("sd").get<std::string>();
+            batch.sd = batch.sdStorage;
+        }
+    }
+
+    static bool isProtobuf(const Http::Mime::MediaType& mime) {
+        return mime.toString().compare(0, sizeof(PROTOBUF_MIME) - 1, PROTOBUF_MIME) == 0;
+    }
+
+    // Function to read a ClientMessage body whose payload must be 'type'
+    static bool readProtobuf(const std::string& body, MessageType type, RestFields& fields, uint64_t& requestId) {
+        thread_local ClientMessage message;  // Reused by every request on this worker
+        if (!message.ParseFromString(body) || message.type() != type) return false;
+        requestId = message.request_id();
+        switch (type) {
+            case REGISTRATION_REQUEST:
+                if (!message.has_reg_req()) return false;
+                fields.id = message.reg_req().id();
+                break;
+            case PDU_SESSION_REQUEST:
+                if (!message.has_pdu_req()) return false;
+                fields.id = message.pdu_req().id();
+                fields.sst = message.pdu_req().sst();
+                fields.sd = message.pdu_req().sd();  // Valid until the next request on this thread
+                break;
+            default:
+                if (!message.has_dereg_req()) return false;
+                fields.id = message.dereg_req().id();
+                break;
+        }
+        return true;
+    }
+
+    // Function to read the fields of a JSON or (by Content-Type) protobuf body.
+    // On failure it sends the 400 reply and returns false.
+    static bool readRequest(const Rest::Request& request, Http::ResponseWriter& response, const RestEndpointLog& log,
+                            MessageType type, unsigned required, RestFields& fields, uint64_t& requestId) {
+        auto contentType = request.headers().tryGet<Http::Header::ContentType>();
+        if (contentType && isProtobuf(contentType->mime())) {
+            if (readProtobuf(request.body(), type, fields, requestId)) return true;
+            LOG_WARN(log.badProtobuf);
+            response.send(Http::Code::Bad_Request, "Invalid protobuf format");
+            return false;
+        }
+        try {
+            readFields(request.body(), required, fields);
+            return true;
+        } catch (const std::exception& e) {
+            LOG_WARN(log.badJson, e.what());
+            response.send(Http::Code::Bad_Request, "Invalid JSON format");
+            return false;
+        }
+    }
+
+    // Function to read a batch body into batch.ids, expanding a range. A batch
+    // names its IDs either as "ids" or as "from" and "to", at most
+    // REST_MAX_BATCH of them. On failure it sends the 400 reply and returns false.
+    static bool readBatch(const Rest::Request& request, Http::ResponseWriter& response, const RestEndpointLog& log,
+                          unsigned required, RestBatch& batch) {
+        try {
+            readBatchFields(request.body(), required, batch);
+        } catch (const std::exception& e) {
+            LOG_WARN(log.badBatchJson, e.what());
+            response.send(Http::Code::Bad_Request, "Invalid JSON format");
+            return false;
+        }
+
+        const unsigned range = REST_FIELD_FROM | REST_FIELD_TO;
+        bool valid;
+        if ((batch.present & (REST_FIELD_IDS | range)) == REST_FIELD_IDS) {
+            valid = batch.ids.size() <= REST_MAX_BATCH;
+        } else if ((batch.present & (REST_FIELD_IDS | range)) == range) {
+            long long count = static_cast<long long>(batch.to) - batch.from + 1;
+            valid = count >= 1 && count <= REST_MAX_BATCH;
+            if (valid) {
+                batch.ids.resize(static_cast<size_t>(count));
+                for (size_t i = 0; i < batch.ids.size(); ++i) batch.ids[i] = batch.from + static_cast<int>(i);
+            }
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            LOG_WARN(log.badBatch, REST_MAX_BATCH);
+            response.send(Http::Code::Bad_Request, "Invalid batch");
+        }
+        return valid;
+    }
+
+    // Per-worker buffers of the batch handlers, reused by every batch request
+    struct BatchBuffers {
+        RestBatch batch;
+        std::vector<AckKind> kinds;
+        std::vector<int> pduIds;
+        std::string reply;
+    };
+
+    static BatchBuffers& batchBuffers() {
+        thread_local BatchBuffers buffers;
+        return buffers;
+    }
+
+    // Function to send 'ack' as the pre-encoded ServerMessage (response_cache.h)
+    // if the Accept header asks for protobuf, otherwise as the preformatted JSON
+    static void sendReply(const Rest::Request& request, Http::ResponseWriter& response, const Ack& ack) {
+        bool protobuf = false;
+        if (auto accept = request.headers().tryGet<Http::Header::Accept>()) {
+            for (const Http::Mime::MediaType& mime : accept->media()) {
+                if (isProtobuf(mime)) protobuf = true;
+            }
+        }
+        if (!protobuf) {
+            sendDurable(response, ack.kind == PDU_ESTABLISHED ? restPduEstablished(ack.pdu_id) : restReply(ack.kind), false);
+            return;
+        }
+
+        thread_local std::string encoded;  // Reused by every reply on this worker
+        encoded.clear();
+        response_cache.append(ack, encoded);
+        sendDurable(response, encoded, true);
+    }
+
+    static void sendOk(Http::ResponseWriter& response, const std::string& body, bool protobuf) {
+        static const Http::Mime::MediaType protobufMime = Http::Mime::MediaType::fromString(PROTOBUF_MIME);
+        if (protobuf) {
+            response.send(Http::Code::Ok, body, protobufMime);
+        } else {
+            response.send(Http::Code::Ok, body);
+        }
+    }
+
+    // Function to send the 200 reply to the request just applied, once the
+    // changes it reports are durable: now, or from the WAL flusher (wal.h)
+    static void sendDurable(Http::ResponseWriter& response, const std::string& body, bool protobuf) {
+        WriteAheadLog* wal = subscriber_core.wal();
+        uint64_t lsn = subscriber_core.durable_point();
+        if (wal == nullptr || lsn <= wal->durable()) {
+            sendOk(response, body, protobuf);
+            return;
+        }
+        auto writer = std::make_shared<Http::ResponseWriter>(std::move(response));
+        wal->defer(lsn, [writer, body, protobuf] { sendOk(*writer, body, protobuf); });
+    }
+
+    void registerUser(const Rest::Request& request, Http::ResponseWriter response) {
+        RestFields fields;
+        Ack ack{};
+        if (!readRequest(request, response, registrationLog, REGISTRATION_REQUEST, REST_FIELD_ID, fields, ack.request_id)) return;
+        ack.id = fields.id;
+        ack.kind = subscriber_core.register_user(fields.id);
+        sendReply(request, response, ack);
+    }
+
+    void pduSession(const Rest::Request& request, Http::ResponseWriter response) {
+        LOG_DEBUG("Raw request body: {}", request.body());
+        RestFields fields;
+        Ack ack{};
+        if (!readRequest(request, response, pduSessionLog, PDU_SESSION_REQUEST,
+                         REST_FIELD_ID | REST_FIELD_SST | REST_FIELD_SD, fields, ack.request_id)) return;
+        ack.id = fields.id;
+        ack.kind = subscriber_core.pdu_session(fields.id, fields.sst, fields.sd.data(), fields.sd.size(), ack.pdu_id);
+        sendReply(request, response, ack);
+    }
+
+    void deregisterUser(const Rest::Request& request, Http::ResponseWriter response) {
+        RestFields fields;
+        Ack ack{};
+        if (!readRequest(request, response, deregistrationLog, DEREGISTRATION_REQUEST, REST_FIELD_ID, fields, ack.request_id)) return;
+        ack.id = fields.id;
+        ack.kind = subscriber_core.deregister_user(fields.id);
+        sendReply(request, response, ack);
+    }
+
+    void registerBatch(const Rest::Request& request, Http::ResponseWriter response) {
+        BatchBuffers& b = batchBuffers();
+        if (!readBatch(request, response, registrationLog, 0, b.batch)) return;
+        b.kinds.resize(b.batch.ids.size());
+        subscriber_core.register_users(b.batch.ids.data(), b.batch.ids.size(), b.kinds.data());
+        formatBatchReply(b.kinds.data(), nullptr, b.kinds.size(), b.reply);
+        sendDurable(response, b.reply, false);
+    }
+
+    void pduSessionBatch(const Rest::Request& request, Http::ResponseWriter response) {
+        BatchBuffers& b = batchBuffers();
+        if (!readBatch(request, response, pduSessionLog, REST_FIELD_SST | REST_FIELD_SD, b.batch)) return;
+        b.kinds.resize(b.batch.ids.size());
+        b.pduIds.resize(b.batch.ids.size());
+        subscriber_core.pdu_sessions(b.batch.ids.data(), b.batch.ids.size(), b.batch.sst,
+                                     b.batch.sd.data(), b.batch.sd.size(), b.kinds.data(), b.pduIds.data());
+        formatBatchReply(b.kinds.data(), b.pduIds.data(), b.kinds.size(), b.reply);
+        sendDurable(response, b.reply, false);
+    }
+
+    void deregisterBatch(const Rest::Request& request, Http::ResponseWriter response) {
+        BatchBuffers& b = batchBuffers();
+        if (!readBatch(request, response, deregistrationLog, 0, b.batch)) return;
+        b.kinds.resize(b.batch.ids.size());
+        subscriber_core.deregister_users(b.batch.ids.data(), b.batch.ids.size(), b.kinds.data());
+        formatBatchReply(b.kinds.data(), nullptr, b.kinds.size(), b.reply);
+        sendDurable(response, b.reply, false);
+    }
+};
+
+// Function to pin the Pistache reactor threads, found by name once they have
+// started, to one CPU each, round-robin over the available CPUs
+inline void pinWorkerThreads(size_t workers) {
+    cpu_set_t available;
+    CPU_ZERO(&available);
+    if (sched_getaffinity(0, sizeof(available), &available) != 0) return;
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &available)) cpus.push_back(cpu);
+    }
+
+    std::vector<pid_t> threads;
+    for (int attempt = 0; attempt < 100 && threads.size() < workers; ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        threads.clear();
+        DIR* dir = opendir("/proc/self/task");
+        if (dir == nullptr) return;
+        while (struct dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] == '.') continue;
+            std::ifstream comm(std::string("/proc/self/task/") + entry->d_name + "/comm");
+            std::string name;
+            if (std::getline(comm, name) && name == WORKER_THREAD_NAME) threads.push_back(std::stoi(entry->d_name));
+        }
+        closedir(dir);
+    }
+    if (threads.size() < workers) {
+        LOG_WARN("Found {} of {} worker threads to pin", threads.size(), workers);
+    }
+
+    std::sort(threads.begin(), threads.end());  // Start order
+    for (size_t i = 0; i < threads.size(); ++i) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpus[i % cpus.size()], &set);
+        sched_setaffinity(threads[i], sizeof(set), &set);
+    }
+}
+
+#endif // REST_SERVER_H
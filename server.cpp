@@ -1,241 +1,142 @@
 #include <iostream>
-#include <unordered_map>
-#include <cstring>
-#include <unistd.h>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <sstream>
-#include <iomanip>
 #include <cstdlib>  // For std::stoi
 #include <getopt.h> // For getopt_long (optional)
 #include <thread>   // For std::thread
-#include "message.pb.h"
-#include <bitset>
+#include <vector>
+#include <algorithm>
+#include <csignal>
+#include "tcp_server.h"
 
-std::unordered_map<int, bool> registered_users; // Stores registered users (ID -> registered flag)
-
-#define DEFAULT_PORT 8081
-
-// Function to validate the hexadecimal string 'sd' (should be a 4-byte hexadecimal number)
-bool is_valid_hexadecimal(const std::string& str) {
-    if (str.size() != 4) return false;  // Ensure it's exactly 4 characters
-    
-    // Check if all characters are hexadecimal digits
-    for (char c : str) {
-        if (!std::isxdigit(c)) return false;
-    }
-
-    // Convert hexadecimal to binary and check if it's exactly 16 bits (4 hex digits)
-    unsigned int hexValue = std::stoi(str, nullptr, 16);  // Convert to unsigned int
-    std::bitset<16> binary(hexValue);  // Convert the hex value to a 16-bit binary
-    
-    // Ensure the binary representation has 4 digits for each hex digit
-    if (binary.size() != 16) return false;
-
-    return true;
-}
-
-// Function to validate 'sst' (should be between 1 and 255)
-bool is_valid_sst(int sst) {
-    return sst >= 1 && sst <= 255;
-}
-
-// Function to handle client requests
-void handle_client(int client_socket) {
-    char buffer[1024] = {0};
-    int bytes_received = recv(client_socket, buffer, sizeof(buffer), 0);
-
-    if (bytes_received <= 0) {
-        std::cerr << "Failed to receive data or connection closed\n";
-        close(client_socket);
-        return;
-    }
-
-    ClientMessage client_msg;
-    if (!client_msg.ParseFromArray(buffer, bytes_received)) {
-        std::cerr << "Error: Failed to parse client message\n";
-        close(client_socket);
-        return;
-    }
-
-    ServerMessage server_msg;
-
-    switch (client_msg.type()) {
-        case REGISTRATION_REQUEST: {
-            int id = client_msg.reg_req().id();
-
-            if (registered_users.find(id) == registered_users.end()) {
-                registered_users[id] = true;  // Mark user as registered
-
-                RegistrationAck* ack = server_msg.mutable_reg_ack();
-                ack->set_id(id);
-                ack->set_status(200);
-                ack->set_status_message("Registration Successful");
-
-                server_msg.set_type(REGISTRATION_ACK);
-                std::cout << "User Registered: " << id << std::endl;
-            } else {
-                RegistrationAck* ack = server_msg.mutable_reg_ack();
-                ack->set_id(id);
-                ack->set_status(400);
-                ack->set_status_message("User Already Registered");
-
-                server_msg.set_type(REGISTRATION_ACK);
-            }
-            break;
-        }
-
-        case PDU_SESSION_REQUEST: {
-            int id = client_msg.pdu_req().id();
-            int sst = client_msg.pdu_req().sst();
-            std::string sd = client_msg.pdu_req().sd();
-
-            // Validate 'sst' (must be between 1 and 255)
-            if (!is_valid_sst(sst)) {
-                PduSessionAck* ack = server_msg.mutable_pdu_ack();
-                ack->set_id(id);
-                ack->set_status(400);
-                ack->set_status_message("Invalid SST Value. Must be between 1 and 255.");
-
-                server_msg.set_type(PDU_SESSION_ACK);
-                break;
-            }
-
-            // Validate 'sd' (must be a valid 4-byte hexadecimal number)
-            if (!is_valid_hexadecimal(sd)) {
-                PduSessionAck* ack = server_msg.mutable_pdu_ack();
-                ack->set_id(id);
-                ack->set_status(400);
-                ack->set_status_message("Invalid SD Value. Must be a 4-byte hexadecimal number.");
-
-                server_msg.set_type(PDU_SESSION_ACK);
-                break;
-            }
-
-            // Check if ID is registered
-            if (registered_users.find(id) == registered_users.end()) {
-                // Reject PDU session request if ID is not registered
-                PduSessionAck* ack = server_msg.mutable_pdu_ack();
-                ack->set_id(id);
-                ack->set_status(403);
-                ack->set_status_message("PDU Session Denied: ID Not Registered");
-
-                server_msg.set_type(PDU_SESSION_ACK);
-            } else {
-                // Assign a PDU ID and approve session
-                PduSessionAck* ack = server_msg.mutable_pdu_ack();
-                ack->set_id(id);
-                ack->set_pdu_id(rand() % 15 + 1); // Random PDU ID (1-15)
-                ack->set_status(200);
-                ack->set_status_message("PDU Session Established");
-
-                server_msg.set_type(PDU_SESSION_ACK);
-                std::cout << "PDU Session Created for User ID: " << id << std::endl;
-            }
-            break;
-        }
-
-        case DEREGISTRATION_REQUEST: {
-            int id = client_msg.dereg_req().id();
-
-            if (registered_users.find(id) != registered_users.end()) {
-                registered_users.erase(id);  // Remove user from registered list
-
-                DeregistrationAck* ack = server_msg.mutable_dereg_ack();
-                ack->set_id(id);
-                ack->set_status(200);
-                ack->set_status_message("Deregistration Successful");
-
-                server_msg.set_type(DEREGISTRATION_ACK);
-                std::cout << "User Deregistered: " << id << std::endl;
-            } else {
-                DeregistrationAck* ack = server_msg.mutable_dereg_ack();
-                ack->set_id(id);
-                ack->set_status(400);
-                ack->set_status_message("Deregistration Failed: ID Not Found");
-
-                server_msg.set_type(DEREGISTRATION_ACK);
-            }
-            break;
-        }
-
-        default:
-            std::cerr << "Unknown request type\n";
-            close(client_socket);
-            return;
-    }
-
-    std::string serialized_response;
-    if (!server_msg.SerializeToString(&serialized_response)) {
-        std::cerr << "Error: Failed to serialize response\n";
-        close(client_socket);
-        return;
-    }
-
-    send(client_socket, serialized_response.c_str(), serialized_response.size(), 0);
-    close(client_socket);
-}
+SubscriberCore subscriber_core;  // Registration and PDU session state, shared by all I/O threads
+ResponseCache response_cache;    // Pre-encoded acks, built once in main
 
 // Function to handle command-line arguments
-void parse_arguments(int argc, char** argv, int& port) {
+void parse_arguments(int argc, char** argv, ServerOptions& options) {
+    static const struct option long_options[] = {
+        {"port",       required_argument, nullptr, 'p'},
+        {"io-threads", required_argument, nullptr, 't'},
+        {"backlog",    required_argument, nullptr, 'b'},
+        {"reuseport",  no_argument,       nullptr, 'r'},
+        {"pin-cpus",   no_argument,       nullptr, 'c'},
+        {"io-engine",  required_argument, nullptr, 'e'},
+        {"framed",     no_argument,       nullptr, 'f'},
+        {"store",      required_argument, nullptr, 's'},
+        {"log-level",  required_argument, nullptr, 'l'},
+        {"admin-port", required_argument, nullptr, 'a'},
+        {"metrics-interval", required_argument, nullptr, 'm'},
+        {"wal",        required_argument, nullptr, 'W'},
+        {"wal-commit-us", required_argument, nullptr, 'u'},
+        {"snapshot",   required_argument, nullptr, 'S'},
+        {"snapshot-interval", required_argument, nullptr, 'i'},
+        {nullptr, 0, nullptr, 0}
+    };
+
     int opt;
-    while ((opt = getopt(argc, argv, "p:")) != -1) {
+    while ((opt = getopt_long(argc, argv, "p:t:b:rce:fs:l:a:m:W:u:S:i:", long_options, nullptr)) != -1) {
         switch (opt) {
             case 'p':
-                port = std::stoi(optarg);  // Convert string to integer
+                options.port = std::stoi(optarg);  // Convert string to integer
+                break;
+            case 't':
+                options.io_threads = std::stoi(optarg);
+                break;
+            case 'b':
+                options.backlog = std::stoi(optarg);
+                break;
+            case 'r':
+                options.reuse_port = true;
+                break;
+            case 'c':
+                options.pin_threads = true;
+                break;
+            case 'e':
+                if (std::string(optarg) == "io_uring") {
+                    options.io_uring = true;
+                } else if (std::string(optarg) != "epoll") {
+                    std::cerr << "Unknown I/O engine: " << optarg << " (expected epoll or io_uring)\n";
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'f':
+                options.framed = true;
+                break;
+            case 's':
+                options.store = optarg;
+                break;
+            case 'l':
+                if (!parse_log_level(optarg, options.log_level)) {
+                    std::cerr << "Unknown log level: " << optarg << " (expected debug, info, warn, error or off)\n";
+                    exit(EXIT_FAILURE);
+                }
+                break;
+            case 'a':
+                options.admin_port = std::stoi(optarg);
+                break;
+            case 'm':
+                options.metrics_interval = std::stoi(optarg);
+                break;
+            case 'W':
+                options.wal_path = optarg;
+                break;
+            case 'u':
+                options.wal_commit_us = std::stoi(optarg);
+                break;
+            case 'S':
+                options.snapshot_path = optarg;
+                break;
+            case 'i':
+                options.snapshot_interval = std::stoi(optarg);
                 break;
             default:
-                std::cerr << "Usage: " << argv[0] << " -p <port>\n";
+                std::cerr << "Usage: " << argv[0] << " -p <port> [--io-threads N] [--backlog N]"
+                          << " [--reuseport] [--pin-cpus] [--io-engine epoll|io_uring] [--framed]"
+                          << " [--store sharded|bitmap] [--log-level debug|info|warn|error|off]"
+                          << " [--admin-port N] [--metrics-interval SECONDS] [--wal PATH] [--wal-commit-us N]"
+                          << " [--snapshot PATH] [--snapshot-interval SECONDS]\n";
                 exit(EXIT_FAILURE);
         }
     }
+
+    if (options.io_threads <= 0) {
+        options.io_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
 }
 
 int main(int argc, char** argv) {
     GOOGLE_PROTOBUF_VERIFY_VERSION;
 
-    int server_fd, client_socket;
-    struct sockaddr_in address;
-    socklen_t addrlen = sizeof(address);
-
-    int port = DEFAULT_PORT;
-    parse_arguments(argc, argv, port);  // Parse command-line arguments for port
+    ServerOptions& options = server_options;
+    parse_arguments(argc, argv, options);  // Parse command-line arguments for port
+    log_level().store(options.log_level);
+    signal(SIGUSR1, adjust_log_level);
+    signal(SIGUSR2, adjust_log_level);
 
-    server_fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_fd == -1) {
-        perror("Socket creation failed");
+    if (!subscriber_core.init(options.store)) {
+        std::cerr << "Unknown store backend: " << options.store << " (expected sharded or bitmap)\n";
         exit(EXIT_FAILURE);
     }
-
-    address.sin_family = AF_INET;
-    address.sin_addr.s_addr = INADDR_ANY;
-    address.sin_port = htons(port);
-
-    if (bind(server_fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
-        perror("Bind failed");
-        close(server_fd);
+    if (!options.snapshot_path.empty() && !subscriber_core.load_snapshot(options.snapshot_path)) {
         exit(EXIT_FAILURE);
     }
-
-    if (listen(server_fd, 5) < 0) {
-        perror("Listen failed");
-        close(server_fd);
+    if (!options.wal_path.empty() && !subscriber_core.open_wal(options.wal_path, options.wal_commit_us)) {
         exit(EXIT_FAILURE);
     }
+    if (!options.snapshot_path.empty() && options.snapshot_interval > 0) {
+        std::thread(&SubscriberCore::snapshot_loop, &subscriber_core, options.snapshot_path,
+                    options.snapshot_interval).detach();
+    }
+    response_cache.init();
 
-    std::cout << "Server listening on port " << port << "...\n";
-
-    while (true) {
-        client_socket = accept(server_fd, (struct sockaddr*)&address, &addrlen);
-        if (client_socket < 0) {
-            perror("Accept failed");
-            continue;
-        }
-        // Handle client requests in a new thread
-        std::thread(handle_client, client_socket).detach();
+    std::vector<int> listeners;
+    std::vector<std::thread> io_threads;
+    if (!start_tcp_server(options, listeners, io_threads)) {
+        exit(EXIT_FAILURE);
+    }
+    for (auto& t : io_threads) {
+        t.join();
     }
 
-    close(server_fd);
+    for (int fd : listeners) close(fd);
     google::protobuf::ShutdownProtobufLibrary();
     return 0;
 }
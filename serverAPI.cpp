@@ -1,126 +1,113 @@
 #include <iostream>
-#include <unordered_map>
-#include <pistache/endpoint.h>
-#include <pistache/router.h>
-#include <pistache/http.h>
-#include <nlohmann/json.hpp>
-
-using namespace Pistache;
-using json = nlohmann::json;
-
-std::unordered_map<int, bool> registered_users; // Stores registered users
-
-class ServerAPI {
-public:
-    explicit ServerAPI(Address addr) : httpEndpoint(std::make_shared<Http::Endpoint>(addr)) {}
-
-    void init(size_t thr = 2) {
-        auto opts = Http::Endpoint::options().threads(thr);
-        httpEndpoint->init(opts);
-        setupRoutes();
-    }
-
-    void start() {
-        httpEndpoint->setHandler(router.handler());
-        httpEndpoint->serve();
+#include <getopt.h>
+#include <csignal>
+#include <algorithm>
+#include <thread>
+#include "rest_server.h"
+
+SubscriberCore subscriber_core;  // Registration and PDU session state, shared by the Pistache workers
+ResponseCache response_cache;    // Pre-encoded protobuf acks, built once in main
+
+int main(int argc, char* argv[]) {
+    GOOGLE_PROTOBUF_VERIFY_VERSION;
+
+    static const struct option long_options[] = {
+        {"port",             required_argument, nullptr, 'p'},
+        {"workers",          required_argument, nullptr, 'w'},
+        {"pin-cpus",         no_argument,       nullptr, 'c'},
+        {"max-request-size", required_argument, nullptr, 'm'},
+        {"store",            required_argument, nullptr, 's'},
+        {"log-level",        required_argument, nullptr, 'l'},
+        {"wal",              required_argument, nullptr, 'W'},
+        {"wal-commit-us",    required_argument, nullptr, 'u'},
+        {"snapshot",         required_argument, nullptr, 'S'},
+        {"snapshot-interval", required_argument, nullptr, 'i'},
+        {nullptr, 0, nullptr, 0}
+    };
+
+    int port = REST_DEFAULT_PORT;
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    bool pinCpus = false;
+    size_t maxRequestSize = 0;
+    std::string store = "sharded";
+    LogLevel level = LOG_LEVEL_INFO;
+    std::string walPath;
+    int walCommitUs = WAL_DEFAULT_COMMIT_US;
+    std::string snapshotPath;
+    int snapshotInterval = SNAPSHOT_DEFAULT_INTERVAL;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "p:w:cm:s:l:W:u:S:i:", long_options, nullptr)) != -1) {
+        switch (opt) {
+            case 'p':
+                port = std::stoi(optarg);
+                break;
+            case 'w':
+                workers = static_cast<size_t>(std::max(1, std::stoi(optarg)));
+                break;
+            case 'c':
+                pinCpus = true;
+                break;
+            case 'm':
+                maxRequestSize = static_cast<size_t>(std::max(0L, std::stol(optarg)));
+                break;
+            case 's':
+                store = optarg;
+                break;
+            case 'l':
+                if (!parse_log_level(optarg, level)) {
+                    std::cerr << "Unknown log level: " << optarg << " (expected debug, info, warn, error or off)\n";
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'W':
+                walPath = optarg;
+                break;
+            case 'u':
+                walCommitUs = std::stoi(optarg);
+                break;
+            case 'S':
+                snapshotPath = optarg;
+                break;
+            case 'i':
+                snapshotInterval = std::stoi(optarg);
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [--port N] [--workers N] [--pin-cpus] [--max-request-size BYTES]"
+                          << " [--store sharded|bitmap] [--log-level debug|info|warn|error|off]"
+                          << " [--wal PATH] [--wal-commit-us N] [--snapshot PATH] [--snapshot-interval SECONDS]\n";
+                return EXIT_FAILURE;
+        }
     }
+    log_level().store(level);
+    signal(SIGUSR1, adjust_log_level);
+    signal(SIGUSR2, adjust_log_level);
 
-private:
-    std::shared_ptr<Http::Endpoint> httpEndpoint;
-    Rest::Router router;
-
-    void setupRoutes() {
-        Rest::Routes::Post(router, "/register", Rest::Routes::bind(&ServerAPI::registerUser, this));
-        Rest::Routes::Post(router, "/pdu-session", Rest::Routes::bind(&ServerAPI::pduSession, this));
-        Rest::Routes::Delete(router, "/deregister", Rest::Routes::bind(&ServerAPI::deregisterUser, this));
+    if (!subscriber_core.init(store)) {
+        std::cerr << "Unknown store backend: " << store << " (expected sharded or bitmap)\n";
+        return EXIT_FAILURE;
     }
-
-    void registerUser(const Rest::Request& request, Http::ResponseWriter response) {
-        try {
-            auto body = json::parse(request.body());
-            int id = body.at("id");
-
-            json responseJson;
-            std::cout << "Received registration request with ID: " << id << std::endl;
-
-            if (registered_users.find(id) == registered_users.end()) {
-                registered_users[id] = true;
-                responseJson["status"] = 200;
-                responseJson["message"] = "Registration Successful";
-            } else {
-                responseJson["status"] = 400;
-                responseJson["message"] = "User Already Registered";
-            }
-            response.send(Http::Code::Ok, responseJson.dump());
-        } catch (const std::exception& e) {
-            std::cerr << "Error parsing registration request: " << e.what() << std::endl;
-            response.send(Http::Code::Bad_Request, "Invalid JSON format");
-        }
+    if (!snapshotPath.empty() && !subscriber_core.load_snapshot(snapshotPath)) {
+        return EXIT_FAILURE;
     }
-
-    void pduSession(const Rest::Request& request, Http::ResponseWriter response) {
-        try {
-            std::string bodyStr = request.body();
-            std::cout << "Raw request body: " << bodyStr << std::endl;
-
-            auto body = json::parse(bodyStr);  // JSON Parsing
-            int id = body.at("id");
-            int sst = body.at("sst");
-            std::string sd = body.at("sd");
-
-            json responseJson;
-            if (registered_users.find(id) == registered_users.end()) {
-                responseJson["status"] = 403;
-                responseJson["message"] = "PDU Session Denied: ID Not Registered";
-            } else if (sst < 1 || sst > 255) {
-                responseJson["status"] = 400;
-                responseJson["message"] = "Invalid SST Value. Must be between 1 and 255.";
-            } else if (sd.size() != 4 || sd.find_first_not_of("01") != std::string::npos) {
-                responseJson["status"] = 400;
-                responseJson["message"] = "Invalid SD Value. Must be a 4-bit binary number (0000-1111).";
-            } else {
-                responseJson["status"] = 200;
-                responseJson["pdu_id"] = rand() % 15 + 1;
-                responseJson["message"] = "PDU Session Established";
-            }
-            response.send(Http::Code::Ok, responseJson.dump());
-        } catch (const json::exception &e) {
-            std::cerr << "Error parsing PDU session request: " << e.what() << std::endl;
-            response.send(Http::Code::Bad_Request, "Invalid JSON format");
-        }
+    if (!walPath.empty() && !subscriber_core.open_wal(walPath, walCommitUs)) {
+        return EXIT_FAILURE;
     }
-
-
-    void deregisterUser(const Rest::Request& request, Http::ResponseWriter response) {
-        try {
-            auto body = json::parse(request.body());
-            int id = body.at("id");
-
-            json responseJson;
-            std::cout << "Received deregistration request with ID: " << id << std::endl;
-
-            if (registered_users.erase(id)) {
-                responseJson["status"] = 200;
-                responseJson["message"] = "Deregistration Successful";
-            } else {
-                responseJson["status"] = 400;
-                responseJson["message"] = "Deregistration Failed: ID Not Found";
-            }
-            response.send(Http::Code::Ok, responseJson.dump());
-        } catch (const std::exception& e) {
-            std::cerr << "Error parsing deregistration request: " << e.what() << std::endl;
-            response.send(Http::Code::Bad_Request, "Invalid JSON format");
-        }
+    if (!snapshotPath.empty() && snapshotInterval > 0) {
+        std::thread(&SubscriberCore::snapshot_loop, &subscriber_core, snapshotPath, snapshotInterval).detach();
     }
-};
+    response_cache.init();
 
-int main() {
-    Address addr(Ipv4::any(), Port(8081));
+    Pistache::Address addr(Pistache::Ipv4::any(), Pistache::Port(static_cast<uint16_t>(port)));
     ServerAPI server(addr);
 
-    server.init();
-    std::cout << "REST API Server running on port 8081...\n";
+    server.init(workers, maxRequestSize);
+    std::cout << "REST API Server running on port " << port << " with " << workers << " worker thread(s)..." << std::endl;
+    if (pinCpus) {
+        // The workers start inside start(), which blocks
+        std::thread(pinWorkerThreads, workers).detach();
+    }
     server.start();
+    google::protobuf::ShutdownProtobufLibrary();
 
     return 0;
 }
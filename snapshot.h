@@ -0,0 +1,347 @@
+// Snapshot of the core's state (subscriber_core.h) in a flat binary file the
+// server maps at startup and serves from directly, so a restart does not
+// rebuild the state ID by ID. The file, in host byte order:
+//   header           SnapshotHeader, padded to SNAPSHOT_HEADER_SIZE
+//   bitmap pages     one 8 KB registration page (registration_store.h) per
+//                    65536-ID range with a registered ID, ascending
+//   session records  one SessionRecord (pdu_session_table.h) per subscriber
+//                    with sessions, ascending by ID
+//   bitmap directory one SnapshotBitmapEntry per bitmap page
+//   session directory one SnapshotSessionEntry per 256-ID session page
+//                    (pdu_session_table.h) with records
+// Every section has a checksum, and loading checks them all, so a snapshot
+// that maps is never found corrupt while serving. The header records the WAL LSN
+// (wal.h) the snapshot covers: the log's later records are replayed on top.
+// A snapshot is written to PATH.tmp and renamed over PATH once synced.
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "checksum.h"
+#include "registration_store.h"
+#include "pdu_session_table.h"
+#include "wal.h"
+
+#define SNAPSHOT_MAGIC "SUBSNAP"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_HEADER_SIZE 4096                 // Keeps the bitmap pages page-aligned
+#define SNAPSHOT_BITMAP_PAGE_SIZE (BITMAP_PAGE_WORDS * sizeof(uint64_t))
+#define SNAPSHOT_WRITE_BUFFER (size_t(1) << 20)
+
+struct SnapshotHeader {
+    char magic[8];                      // SNAPSHOT_MAGIC
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t wal_lsn;                   // Last WAL record the snapshot covers
+    uint64_t registered;                // Registered IDs
+    uint64_t session_records;
+    uint32_t bitmap_pages;
+    uint32_t session_pages;             // Session directory entries
+    uint64_t bitmap_offset;
+    uint64_t records_offset;
+    uint64_t bitmap_directory_offset;
+    uint64_t session_directory_offset;
+    uint32_t bitmap_directory_crc;      // crc32() of the bitmap directory
+    uint32_t session_directory_crc;     // crc32() of the session directory
+    uint32_t reserved;
+    uint32_t header_crc;                // crc32() of the bytes before this field
+};
+static_assert(sizeof(SnapshotHeader) == 96, "Snapshot header must be 96 bytes");
+
+struct SnapshotBitmapEntry {
+    uint32_t index;                     // ID range (id >> 16)
+    uint32_t crc;                       // crc32() of the page
+};
+
+struct SnapshotSessionEntry {
+    uint32_t index;                     // Session page (id >> SESSION_PAGE_BITS)
+    uint32_t count;
+    uint32_t crc;                       // crc32() of the range's records
+    uint32_t reserved;
+    uint64_t first_record;
+};
+static_assert(sizeof(SnapshotSessionEntry) == 24, "Snapshot session entries must be 24 bytes");
+
+// Streams a snapshot to PATH.tmp: add the bitmap pages, then the session
+// records, each in ascending order, then commit(). An uncommitted file is
+// deleted. Every call after a failed write does nothing; commit() reports it.
+class SnapshotWriter {
+public:
+    SnapshotWriter() = default;
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    ~SnapshotWriter() {
+        if (fd_ >= 0) {
+            close(fd_);
+            unlink(temp_path_.c_str());
+        }
+    }
+
+    bool open(const std::string& path) {
+        path_ = path;
+        temp_path_ = path + ".tmp";
+        fd_ = ::open(temp_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) return fail("Cannot create");
+        buffer_.reserve(SNAPSHOT_WRITE_BUFFER);
+        buffer_.assign(SNAPSHOT_HEADER_SIZE, 0);  // Written for real by commit()
+        return true;
+    }
+
+    void add_bitmap_page(uint32_t index, const uint64_t* words) {
+        SnapshotBitmapEntry entry{index, crc32(words, SNAPSHOT_BITMAP_PAGE_SIZE)};
+        bitmap_directory_.push_back(entry);
+        for (uint32_t w = 0; w < BITMAP_PAGE_WORDS; ++w) registered_ += __builtin_popcountll(words[w]);
+        append(words, SNAPSHOT_BITMAP_PAGE_SIZE);
+    }
+
+    void add_session(const SessionRecord& record) {
+        uint32_t index = record.id >> SESSION_PAGE_BITS;
+        if (session_directory_.empty() || session_directory_.back().index != index) {
+            session_directory_.push_back(SnapshotSessionEntry{index, 0, 0, 0, session_records_});
+        }
+        SnapshotSessionEntry& entry = session_directory_.back();
+        entry.crc = crc32(&record, sizeof(record), entry.crc);
+        ++entry.count;
+        ++session_records_;
+        append(&record, sizeof(record));
+    }
+
+    // Function to write the directories and header, sync, and rename the file
+    // over PATH. 'wal_lsn' is the last WAL record the contents cover.
+    bool commit(uint64_t wal_lsn) {
+        SnapshotHeader header{};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        header.version = SNAPSHOT_VERSION;
+        header.header_size = SNAPSHOT_HEADER_SIZE;
+        header.wal_lsn = wal_lsn;
+        header.registered = registered_;
+        header.session_records = session_records_;
+        header.bitmap_pages = static_cast<uint32_t>(bitmap_directory_.size());
+        header.session_pages = static_cast<uint32_t>(session_directory_.size());
+        header.bitmap_offset = SNAPSHOT_HEADER_SIZE;
+        header.records_offset = header.bitmap_offset + uint64_t(header.bitmap_pages) * SNAPSHOT_BITMAP_PAGE_SIZE;
+        header.bitmap_directory_offset = header.records_offset + session_records_ * sizeof(SessionRecord);
+        header.session_directory_offset = header.bitmap_directory_offset +
+                                          bitmap_directory_.size() * sizeof(SnapshotBitmapEntry);
+        size_t padding = (8 - header.session_directory_offset % 8) % 8;  // Aligns the session directory
+        header.session_directory_offset += padding;
+        header.bitmap_directory_crc = crc32(bitmap_directory_.data(), bitmap_directory_.size() * sizeof(SnapshotBitmapEntry));
+        header.session_directory_crc = crc32(session_directory_.data(),
+                                             session_directory_.size() * sizeof(SnapshotSessionEntry));
+        header.header_crc = crc32(&header, offsetof(SnapshotHeader, header_crc));
+
+        append(bitmap_directory_.data(), bitmap_directory_.size() * sizeof(SnapshotBitmapEntry));
+        static const char zeros[8] = {};
+        append(zeros, padding);
+        append(session_directory_.data(), session_directory_.size() * sizeof(SnapshotSessionEntry));
+        flush();
+        if (failed_) return false;
+        if (pwrite(fd_, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) return fail("Cannot write");
+        if (fsync(fd_) != 0) return fail("Cannot sync");
+        if (rename(temp_path_.c_str(), path_.c_str()) != 0) return fail("Cannot rename");
+        close(fd_);
+        fd_ = -1;
+        if (!sync_parent_directory(path_)) {
+            std::cerr << "Cannot sync the directory of snapshot " << path_ << ": " << strerror(errno) << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t registered() const { return registered_; }
+    uint64_t session_records() const { return session_records_; }
+
+private:
+    bool fail(const char* what) {
+        std::cerr << what << " snapshot " << temp_path_ << ": " << strerror(errno) << "\n";
+        failed_ = true;
+        return false;
+    }
+
+    void append(const void* data, size_t len) {
+        const char* p = static_cast<const char*>(data);
+        while (len > 0 && !failed_) {
+            size_t n = std::min(len, SNAPSHOT_WRITE_BUFFER - buffer_.size());
+            buffer_.insert(buffer_.end(), p, p + n);
+            p += n;
+            len -= n;
+            if (buffer_.size() == SNAPSHOT_WRITE_BUFFER) flush();
+        }
+    }
+
+    void flush() {
+        size_t written = 0;
+        while (written < buffer_.size() && !failed_) {
+            ssize_t n = write(fd_, buffer_.data() + written, buffer_.size() - written);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                fail("Cannot write");
+                break;
+            }
+            written += static_cast<size_t>(n);
+        }
+        buffer_.clear();
+    }
+
+    std::string path_;
+    std::string temp_path_;
+    int fd_ = -1;
+    bool failed_ = false;
+    std::vector<char> buffer_;
+    std::vector<SnapshotBitmapEntry> bitmap_directory_;
+    std::vector<SnapshotSessionEntry> session_directory_;
+    uint64_t registered_ = 0;
+    uint64_t session_records_ = 0;
+};
+
+// A snapshot file mapped read-only. The stores keep it alive (as their
+// 'owner') while they serve from it.
+class MappedSnapshot {
+public:
+    ~MappedSnapshot() {
+        if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+    }
+
+    MappedSnapshot(const MappedSnapshot&) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+    // Maps and checks the snapshot at 'path'. Returns nullptr if it cannot
+    // be read or is not a valid snapshot.
+    static std::shared_ptr<MappedSnapshot> map(const std::string& path) {
+        std::shared_ptr<MappedSnapshot> snapshot(new MappedSnapshot());
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return fail(path, strerror(errno));
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return fail(path, strerror(errno));
+        }
+        snapshot->size_ = static_cast<size_t>(st.st_size);
+        if (snapshot->size_ < SNAPSHOT_HEADER_SIZE) {
+            close(fd);
+            return fail(path, "file too short");
+        }
+        void* data = mmap(nullptr, snapshot->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) return fail(path, strerror(errno));
+        snapshot->data_ = static_cast<const char*>(data);
+
+        const char* error = snapshot->validate();
+        if (error != nullptr) return fail(path, error);
+        return snapshot;
+    }
+
+    const SnapshotHeader& header() const { return *reinterpret_cast<const SnapshotHeader*>(data_); }
+
+    // Function to list the registration pages, pointing into the mapping
+    std::vector<RegistrationPage> registration_pages() const {
+        std::vector<RegistrationPage> pages;
+        const SnapshotBitmapEntry* directory = at<SnapshotBitmapEntry>(header().bitmap_directory_offset);
+        for (uint32_t i = 0; i < header().bitmap_pages; ++i) {
+            pages.push_back(RegistrationPage{directory[i].index, bitmap_page(i)});
+        }
+        return pages;
+    }
+
+    // Function to list the session records by page, pointing into the mapping
+    std::vector<SessionPageSource> session_pages() const {
+        std::vector<SessionPageSource> pages;
+        const SnapshotSessionEntry* directory = at<SnapshotSessionEntry>(header().session_directory_offset);
+        const SessionRecord* records = at<SessionRecord>(header().records_offset);
+        for (uint32_t i = 0; i < header().session_pages; ++i) {
+            const SnapshotSessionEntry& entry = directory[i];
+            pages.push_back(SessionPageSource{entry.index, entry.count, records + entry.first_record});
+        }
+        return pages;
+    }
+
+private:
+    MappedSnapshot() = default;
+
+    static std::shared_ptr<MappedSnapshot> fail(const std::string& path, const char* error) {
+        std::cerr << "Cannot load snapshot " << path << ": " << error << "\n";
+        return nullptr;
+    }
+
+    template <typename T>
+    const T* at(uint64_t offset) const { return reinterpret_cast<const T*>(data_ + offset); }
+
+    const uint64_t* bitmap_page(uint32_t i) const {
+        return at<uint64_t>(header().bitmap_offset + uint64_t(i) * SNAPSHOT_BITMAP_PAGE_SIZE);
+    }
+
+    // True if [offset, offset + count * size) lies in the file, suitably aligned
+    bool fits(uint64_t offset, uint64_t count, uint64_t size, uint64_t alignment) const {
+        return offset % alignment == 0 && offset <= size_ && count <= (size_ - offset) / size;
+    }
+
+    // Function to check every section. Returns an error or nullptr.
+    const char* validate() const {
+        const SnapshotHeader& h = header();
+        if (std::memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) return "not a snapshot";
+        if (h.header_crc != crc32(&h, offsetof(SnapshotHeader, header_crc))) return "corrupt header";
+        if (h.version != SNAPSHOT_VERSION) return "unsupported version";
+        if (h.header_size != SNAPSHOT_HEADER_SIZE || h.bitmap_pages > BITMAP_PAGE_COUNT ||
+            h.session_pages > SESSION_PAGE_COUNT ||
+            !fits(h.bitmap_offset, h.bitmap_pages, SNAPSHOT_BITMAP_PAGE_SIZE, 8) ||
+            !fits(h.records_offset, h.session_records, sizeof(SessionRecord), 4) ||
+            !fits(h.bitmap_directory_offset, h.bitmap_pages, sizeof(SnapshotBitmapEntry), 4) ||
+            !fits(h.session_directory_offset, h.session_pages, sizeof(SnapshotSessionEntry), 8)) {
+            return "corrupt layout";
+        }
+
+        const SnapshotBitmapEntry* bitmap_directory = at<SnapshotBitmapEntry>(h.bitmap_directory_offset);
+        if (crc32(bitmap_directory, h.bitmap_pages * sizeof(SnapshotBitmapEntry)) != h.bitmap_directory_crc) {
+            return "corrupt bitmap directory";
+        }
+        for (uint32_t i = 0; i < h.bitmap_pages; ++i) {
+            if (bitmap_directory[i].index >= BITMAP_PAGE_COUNT ||
+                (i > 0 && bitmap_directory[i].index <= bitmap_directory[i - 1].index)) {
+                return "corrupt bitmap directory";
+            }
+            if (crc32(bitmap_page(i), SNAPSHOT_BITMAP_PAGE_SIZE) != bitmap_directory[i].crc) return "corrupt bitmap page";
+        }
+
+        const SnapshotSessionEntry* session_directory = at<SnapshotSessionEntry>(h.session_directory_offset);
+        if (crc32(session_directory, h.session_pages * sizeof(SnapshotSessionEntry)) != h.session_directory_crc) {
+            return "corrupt session directory";
+        }
+        const SessionRecord* records = at<SessionRecord>(h.records_offset);
+        uint64_t next_record = 0;
+        for (uint32_t i = 0; i < h.session_pages; ++i) {
+            const SnapshotSessionEntry& entry = session_directory[i];
+            if (entry.index >= SESSION_PAGE_COUNT || (i > 0 && entry.index <= session_directory[i - 1].index) ||
+                entry.first_record != next_record || entry.count > h.session_records - next_record) {
+                return "corrupt session directory";
+            }
+            const SessionRecord* page = records + entry.first_record;
+            if (crc32(page, entry.count * sizeof(SessionRecord)) != entry.crc) return "corrupt session records";
+            for (uint32_t r = 0; r < entry.count; ++r) {
+                if (page[r].id >> SESSION_PAGE_BITS != entry.index || (r > 0 && page[r].id <= page[r - 1].id)) {
+                    return "corrupt session records";
+                }
+            }
+            next_record += entry.count;
+        }
+        if (next_record != h.session_records) return "corrupt session directory";
+        return nullptr;
+    }
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,390 @@
+// Subscriber state and request rules shared by every front-end: the protobuf
+// TCP server (tcp_server.h), the REST server (rest_server.h) and the combined
+// binary that runs both in one process. The core owns the registration store
+// and the PDU session table, validates sst/sd the same way for every caller
+// and decides each request's outcome as an AckKind; the front-ends only decode
+// requests and encode the outcome in their own wire format. Outcomes are
+// counted per thread, whichever front-end asked.
+// With a write-ahead log (wal.h) every change is also logged, and a front-end
+// holds each reply until durable() reaches the request's durable_point().
+// A snapshot (snapshot.h) loaded at startup is served in place, with only the
+// log's records after it replayed; snapshots written while serving let the
+// log drop its older records.
+// Each binary defines the one SubscriberCore instance, 'subscriber_core'.
+#ifndef SUBSCRIBER_CORE_H
+#define SUBSCRIBER_CORE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "registration_store.h"
+#include "pdu_session_table.h"
+#include "wal.h"
+#include "snapshot.h"
+#include "logger.h"
+#include "metrics.h"
+
+// Every outcome of a request, and so every ack a front-end can send
+enum AckKind {
+    REG_SUCCESSFUL,
+    REG_ALREADY_REGISTERED,
+    PDU_INVALID_SST,
+    PDU_INVALID_SD,
+    PDU_NOT_REGISTERED,
+    PDU_ESTABLISHED,
+    PDU_NO_FREE_ID,
+    DEREG_SUCCESSFUL,
+    DEREG_NOT_FOUND,
+    ACK_KIND_COUNT
+};
+
+// Status code and message carried by every ack of one kind
+struct AckDefinition {
+    int status;
+    const char* message;
+    const char* name;       // For metrics
+};
+
+inline const AckDefinition& ack_definition(AckKind kind) {
+    static const AckDefinition definitions[ACK_KIND_COUNT] = {
+        {200, "Registration Successful",                               "reg_successful"},
+        {400, "User Already Registered",                               "reg_already_registered"},
+        {400, "Invalid SST Value. Must be between 1 and 255.",         "pdu_invalid_sst"},
+        {400, "Invalid SD Value. Must be a 4-digit hexadecimal number.", "pdu_invalid_sd"},
+        {403, "PDU Session Denied: ID Not Registered",                 "pdu_not_registered"},
+        {200, "PDU Session Established",                               "pdu_established"},
+        {409, "PDU Session Denied: No Free PDU ID",                    "pdu_no_free_id"},
+        {200, "Deregistration Successful",                             "dereg_successful"},
+        {400, "Deregistration Failed: ID Not Found",                   "dereg_not_found"},
+    };
+    return definitions[kind];
+}
+
+// Function to validate 'sst' (should be between 1 and 255)
+inline bool is_valid_sst(int sst) {
+    return sst >= 1 && sst <= 255;
+}
+
+// Function to validate 'sd' (exactly 4 hexadecimal digits) and decode its 16-bit value
+inline bool parse_sd(const char* sd, size_t len, uint16_t& value) {
+    if (len != 4) return false;
+    unsigned result = 0;
+    for (size_t i = 0; i < len; ++i) {
+        char c = sd[i];
+        unsigned digit;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<unsigned>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<unsigned>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = static_cast<unsigned>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        result = result << 4 | digit;
+    }
+    value = static_cast<uint16_t>(result);
+    return true;
+}
+
+#define ID_LOCKS 1024   // Stripes of the per-ID locks that serialize each subscriber's changes
+#define SNAPSHOT_DEFAULT_INTERVAL 300   // Seconds between snapshots
+
+// Outcomes decided by one thread
+struct CoreMetricsShard {
+    Counter acks[ACK_KIND_COUNT];
+};
+
+class SubscriberCore {
+public:
+    // Creates the registration store; false if 'store' names no backend
+    bool init(const std::string& store) {
+        users_ = make_registration_store(store);
+        return users_ != nullptr;
+    }
+
+    // Takes the snapshot at 'path' as the state, after init() and before
+    // open_wal(); its pages are read as requests use them. A missing file
+    // leaves the state empty. False if the file is not a valid snapshot.
+    bool load_snapshot(const std::string& path) {
+        if (access(path.c_str(), F_OK) != 0) {
+            LOG_INFO("Snapshot: {} not found, starting empty", path);
+            return true;
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<MappedSnapshot> snapshot = MappedSnapshot::map(path);
+        if (!snapshot) return false;
+        users_->load_pages(snapshot->registration_pages(), snapshot);
+        sessions_.load_base(snapshot->session_pages(), snapshot);
+        snapshot_lsn_ = snapshot->header().wal_lsn;
+        LOG_INFO("Snapshot: loaded {} registered IDs and {} subscribers with sessions (WAL LSN {}) in {} ms",
+                 snapshot->header().registered, snapshot->header().session_records, snapshot_lsn_,
+                 std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+        return true;
+    }
+
+    // Rebuilds the state from the log at 'path' (its records after the
+    // loaded snapshot, if any), then logs every change. False if the log
+    // cannot be opened or read.
+    bool open_wal(const std::string& path, int commit_us) {
+        std::unique_ptr<WriteAheadLog> wal(new WriteAheadLog());
+        if (!wal->open(path, commit_us, snapshot_lsn_, [this](const WalRecord& record) { apply(record); })) {
+            return false;
+        }
+        wal_ = std::move(wal);
+        return true;
+    }
+
+    // Writes the state to 'path' while requests go on. The snapshot is fuzzy:
+    // it holds every change up to the LSN it records and maybe some later
+    // ones, which replaying the log's later records redoes harmlessly (every
+    // record sets state rather than adjusting it). With a log, the log is
+    // rolled first and its records before the roll are deleted once the
+    // snapshot is in place. False if the snapshot cannot be written.
+    bool write_snapshot(const std::string& path) {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        auto start = std::chrono::steady_clock::now();
+        if (wal_) wal_->roll();
+        uint64_t lsn = wal_ ? wal_->appended() : snapshot_lsn_;
+        SnapshotWriter writer;
+        if (!writer.open(path)) return false;
+        users_->export_pages([&](uint32_t index, const uint64_t* words) { writer.add_bitmap_page(index, words); });
+        sessions_.export_sessions([&](const SessionRecord& record) { writer.add_session(record); });
+        if (wal_) {
+            // A change seen above is logged before its ID's lock is released;
+            // once those records are durable, no change in the snapshot can
+            // be lost from the log in a crash
+            for (std::mutex& id_lock : id_locks_) {
+                id_lock.lock();
+                id_lock.unlock();
+            }
+            wal_->wait_durable(wal_->appended());
+        }
+        if (!writer.commit(lsn)) return false;
+        if (wal_) wal_->drop_previous();
+        snapshot_lsn_ = lsn;
+        LOG_INFO("Snapshot: wrote {} registered IDs and {} subscribers with sessions (WAL LSN {}) in {} ms",
+                 writer.registered(), writer.session_records(), lsn,
+                 std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+        return true;
+    }
+
+    // Function to write a snapshot to 'path' every 'seconds' seconds; runs forever
+    void snapshot_loop(const std::string& path, int seconds) {
+        while (true) {
+            std::this_thread::sleep_for(std::chrono::seconds(seconds));
+            if (!write_snapshot(path)) LOG_ERROR("Snapshot: cannot write {}", path);
+        }
+    }
+
+    // The log, or nullptr if changes are not logged
+    WriteAheadLog* wal() const { return wal_.get(); }
+
+    // LSN the reply to the request just decided on this thread must wait for:
+    // it covers the request's own change and any it observed (0 without a log)
+    uint64_t durable_point() const { return wal_ ? wal_->appended() : 0; }
+
+    AckKind register_user(int32_t id) {
+        {
+            std::unique_lock<std::mutex> lock = lock_id(id);
+            if (!users_->register_id(id)) return count(REG_ALREADY_REGISTERED);
+            log_change(WAL_REGISTER, id);
+        }
+        LOG_INFO("User Registered: {}", id);
+        return count(REG_SUCCESSFUL);
+    }
+
+    // Validates the S-NSSAI, then assigns the lowest free PDU ID (1-15) to
+    // 'pdu_id' and records the session
+    AckKind pdu_session(int32_t id, int sst, const char* sd, size_t sd_len, int& pdu_id) {
+        pdu_id = 0;
+        uint16_t sd_value = 0;
+        if (!is_valid_sst(sst)) return count(PDU_INVALID_SST);
+        if (!parse_sd(sd, sd_len, sd_value)) return count(PDU_INVALID_SD);
+        AckKind kind = establish(id, static_cast<uint8_t>(sst), sd_value, pdu_id);
+        if (kind == PDU_ESTABLISHED) LOG_INFO("PDU Session Created for User ID: {}, PDU ID: {}", id, pdu_id);
+        return kind;
+    }
+
+    // Removes the user and frees all of its PDU sessions
+    AckKind deregister_user(int32_t id) {
+        {
+            std::unique_lock<std::mutex> lock = lock_id(id);
+            if (!users_->deregister_id(id)) return count(DEREG_NOT_FOUND);
+            sessions_.release_all(id);
+            log_change(WAL_DEREGISTER, id);
+        }
+        LOG_INFO("User Deregistered: {}", id);
+        return count(DEREG_SUCCESSFUL);
+    }
+
+    // Batch forms for bulk provisioning: kinds[i] (and pdu_ids[i]) is the
+    // outcome for ids[i], exactly as the single-ID calls in batch order would
+    // decide it. Registrations and deregistrations make one pass over the
+    // store (registration_store.h), or with a log one ID at a time, each
+    // change logged under its ID's lock; deregistered users' sessions are
+    // released under their ID's lock either way. One summary line is logged per batch.
+    void register_users(const int* ids, size_t n, AckKind* kinds) {
+        std::vector<uint8_t>& changed = batch_flags(n);
+        if (wal_) {
+            for (size_t i = 0; i < n; ++i) {
+                std::unique_lock<std::mutex> lock = lock_id(ids[i]);
+                changed[i] = users_->register_id(ids[i]);
+                if (changed[i]) log_change(WAL_REGISTER, ids[i]);
+            }
+        } else {
+            users_->register_ids(ids, n, changed.data());
+        }
+        size_t registered = 0;
+        for (size_t i = 0; i < n; ++i) {
+            registered += changed[i];
+            kinds[i] = count(changed[i] ? REG_SUCCESSFUL : REG_ALREADY_REGISTERED);
+        }
+        LOG_INFO("Batch registered {} of {} users", registered, n);
+    }
+
+    // Every session of the batch uses the same S-NSSAI, validated once
+    void pdu_sessions(const int* ids, size_t n, int sst, const char* sd, size_t sd_len,
+                      AckKind* kinds, int* pdu_ids) {
+        uint16_t sd_value = 0;
+        AckKind invalid = ACK_KIND_COUNT;
+        if (!is_valid_sst(sst)) {
+            invalid = PDU_INVALID_SST;
+        } else if (!parse_sd(sd, sd_len, sd_value)) {
+            invalid = PDU_INVALID_SD;
+        }
+        size_t established = 0;
+        for (size_t i = 0; i < n; ++i) {
+            pdu_ids[i] = 0;
+            if (invalid != ACK_KIND_COUNT) {
+                kinds[i] = count(invalid);
+            } else {
+                kinds[i] = establish(ids[i], static_cast<uint8_t>(sst), sd_value, pdu_ids[i]);
+                established += kinds[i] == PDU_ESTABLISHED;
+            }
+        }
+        LOG_INFO("Batch created {} of {} PDU sessions", established, n);
+    }
+
+    void deregister_users(const int* ids, size_t n, AckKind* kinds) {
+        std::vector<uint8_t>& changed = batch_flags(n);
+        size_t deregistered = 0;
+        if (wal_) {
+            for (size_t i = 0; i < n; ++i) {
+                std::unique_lock<std::mutex> lock = lock_id(ids[i]);
+                changed[i] = users_->deregister_id(ids[i]);
+                if (changed[i]) {
+                    sessions_.release_all(ids[i]);
+                    log_change(WAL_DEREGISTER, ids[i]);
+                }
+            }
+        } else {
+            users_->deregister_ids(ids, n, changed.data());
+            // A session established before the ID lock is taken here is released with the rest
+            for (size_t i = 0; i < n; ++i) {
+                if (!changed[i]) continue;
+                std::unique_lock<std::mutex> lock = lock_id(ids[i]);
+                sessions_.release_all(ids[i]);
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            deregistered += changed[i];
+            kinds[i] = count(changed[i] ? DEREG_SUCCESSFUL : DEREG_NOT_FOUND);
+        }
+        LOG_INFO("Batch deregistered {} of {} users", deregistered, n);
+    }
+
+    // Function to render the outcome counters, summed over all threads
+    std::string metrics_report() const {
+        uint64_t totals[ACK_KIND_COUNT] = {};
+        metrics_.for_each([&](const CoreMetricsShard& shard) {
+            for (int kind = 0; kind < ACK_KIND_COUNT; ++kind) totals[kind] += shard.acks[kind].get();
+        });
+        std::string out;
+        for (int kind = 0; kind < ACK_KIND_COUNT; ++kind) {
+            out += std::string("ack_") + ack_definition(static_cast<AckKind>(kind)).name + " " +
+                   std::to_string(totals[kind]) + "\n";
+        }
+        return out;
+    }
+
+private:
+    AckKind count(AckKind kind) {
+        metrics_.local().acks[kind].add();
+        return kind;
+    }
+
+    // Assigns the lowest free PDU ID if the user is registered
+    AckKind establish(int32_t id, uint8_t sst, uint16_t sd_value, int& pdu_id) {
+        std::unique_lock<std::mutex> lock = lock_id(id);
+        if (!users_->is_registered(id)) return count(PDU_NOT_REGISTERED);
+        pdu_id = sessions_.allocate(id, sst, sd_value);
+        if (pdu_id == 0) return count(PDU_NO_FREE_ID);
+        log_change(WAL_PDU_SESSION, id, static_cast<uint8_t>(pdu_id), sst, sd_value);
+        return count(PDU_ESTABLISHED);
+    }
+
+    // A subscriber's registration check and session changes are made under
+    // its ID's lock, so a PDU session cannot be allocated after a concurrent
+    // deregistration released the user's sessions. With a log, each record
+    // is appended under the same lock, so the log holds each subscriber's
+    // changes in the order they were applied.
+    std::unique_lock<std::mutex> lock_id(int32_t id) {
+        return std::unique_lock<std::mutex>(id_locks_[static_cast<uint32_t>(id) % ID_LOCKS]);
+    }
+
+    void log_change(WalOp op, int32_t id, uint8_t pdu_id = 0, uint8_t sst = 0, uint16_t sd = 0) {
+        if (!wal_) return;
+        WalRecord record{};
+        record.op = op;
+        record.id = id;
+        record.pdu_id = pdu_id;
+        record.sst = sst;
+        record.sd = sd;
+        wal_->append(record);
+    }
+
+    // Function to replay one logged change
+    void apply(const WalRecord& record) {
+        switch (record.op) {
+            case WAL_REGISTER:
+                users_->register_id(record.id);
+                break;
+            case WAL_DEREGISTER:
+                users_->deregister_id(record.id);
+                sessions_.release_all(record.id);
+                break;
+            case WAL_PDU_SESSION:
+                sessions_.restore(record.id, record.pdu_id, record.sst, record.sd);
+                break;
+            default:
+                LOG_WARN("WAL: skipped record with unknown op {}", record.op);
+                break;
+        }
+    }
+
+    // Per-thread scratch flags for the batch calls
+    static std::vector<uint8_t>& batch_flags(size_t n) {
+        thread_local std::vector<uint8_t> flags;
+        flags.resize(n);
+        return flags;
+    }
+
+    std::unique_ptr<RegistrationStore> users_;
+    PduSessionTable sessions_;
+    ShardedMetrics<CoreMetricsShard> metrics_;
+    std::unique_ptr<WriteAheadLog> wal_;
+    std::mutex id_locks_[ID_LOCKS];
+    std::mutex snapshot_mutex_;      // One snapshot at a time
+    uint64_t snapshot_lsn_ = 0;      // WAL LSN of the last snapshot loaded or written
+};
+
+extern SubscriberCore subscriber_core;
+
+#endif // SUBSCRIBER_CORE_H
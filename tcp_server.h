@@ -0,0 +1,1110 @@
+// Protobuf TCP front-end: a fixed pool of epoll or io_uring I/O threads that
+// decode ClientMessages (one per connection, or length-prefixed frames on
+// persistent connections), apply them to the shared core (subscriber_core.h)
+// and reply with pre-encoded acks (response_cache.h). Per-thread metrics are
+// served on an optional admin port. With a write-ahead log (--wal) a reply is
+// held until the log group holding its request's changes is durable; the I/O
+// thread keeps serving other connections meanwhile. server.cpp runs it on its
+// own and combinedServer.cpp next to the REST front-end. The front-end's
+// globals are defined here, so include it from one translation unit only.
+#ifndef TCP_SERVER_H
+#define TCP_SERVER_H
+
+#include <iostream>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <sstream>
+#include <iomanip>
+#include <thread>   // For std::thread
+#include <chrono>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <functional>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <pthread.h>
+#include <sched.h>
+#include "message.pb.h"
+#include <google/protobuf/arena.h>
+#include "uring.h"
+#include "framing.h"
+#include "subscriber_core.h"
+#include "response_cache.h"
+#include "logger.h"
+#include "metrics.h"
+
+#define TCP_DEFAULT_PORT 8081
+#define MAX_EVENTS 1024   // epoll events handled per wakeup
+#define READ_CHUNK 4096   // recv() size while draining a socket
+#define ARENA_BLOCK_SIZE (64 * 1024)  // Per-thread protobuf arena block, reused for every request
+#define URING_ENTRIES 4096      // io_uring submission queue depth per I/O thread
+#define URING_BUFFERS 1024      // Provided recv buffers per I/O thread (power of two)
+
+// Server configuration collected from the command line
+struct ServerOptions {
+    int port = TCP_DEFAULT_PORT;
+    int io_threads = 0;          // 0 = one per hardware thread
+    int backlog = SOMAXCONN;     // listen() backlog per listening socket
+    bool reuse_port = false;     // One SO_REUSEPORT listener per I/O thread
+    bool pin_threads = false;    // Pin I/O thread i to CPU i (mod CPU count)
+    bool io_uring = false;       // Use the io_uring engine instead of epoll
+    bool framed = false;         // Persistent connections with length-prefixed messages
+    std::string store = "sharded";  // Registration store backend: sharded or bitmap
+    LogLevel log_level = LOG_LEVEL_INFO;  // Startup log level; SIGUSR1/SIGUSR2 change it at runtime
+    int admin_port = 0;          // Serve metrics over HTTP on 127.0.0.1:admin_port (0 = off)
+    int metrics_interval = 0;    // Dump metrics to stdout every N seconds (0 = off)
+    std::string wal_path;        // Write-ahead log file ("" = state is not persisted)
+    int wal_commit_us = WAL_DEFAULT_COMMIT_US;  // Group commit latency budget
+    std::string snapshot_path;   // Snapshot loaded at startup and rewritten periodically ("" = none)
+    int snapshot_interval = SNAPSHOT_DEFAULT_INTERVAL;  // Seconds between snapshots (0 = load only)
+};
+
+ServerOptions server_options;
+
+// Request processing stages timed per request type
+enum MetricStage { STAGE_PARSE, STAGE_DISPATCH, STAGE_SERIALIZE, STAGE_SEND, STAGE_COUNT };
+#define METRIC_REQUEST_TYPES 4   // REGISTRATION, PDU_SESSION, DEREGISTRATION, BATCH (MessageType / 2)
+#define METRIC_STATUSES 5        // 200, 400, 403, 409, other
+
+// Metrics recorded by one I/O thread
+struct ServerMetricsShard {
+    Counter connections_accepted;
+    Counter connections_closed;
+    Counter requests;
+    Counter parse_failures;
+    Counter unknown_types;
+    Counter oversized_frames;
+    LatencyHistogram accept_to_recv;                                        // Accept -> first bytes
+    LatencyHistogram stages[STAGE_COUNT][METRIC_REQUEST_TYPES];
+    LatencyHistogram requests_by_status[METRIC_REQUEST_TYPES][METRIC_STATUSES];  // Received -> reply queued
+};
+
+ShardedMetrics<ServerMetricsShard> server_metrics;
+uint64_t server_start_ns = 0;
+
+// Function to map a status code to its metrics slot
+int metric_status(int status) {
+    switch (status) {
+        case 200: return 0;
+        case 400: return 1;
+        case 403: return 2;
+        case 409: return 3;
+        default:  return 4;
+    }
+}
+
+// A queued reply whose request's changes were not yet durable
+struct WalReply {
+    uint64_t lsn;    // WAL record the reply waits for
+    uint64_t start;  // Stream position of its first byte (see Connection::out_start)
+};
+
+// Per-connection state driven by the event loop
+struct Connection {
+    int fd;
+    std::string in;          // Bytes received and not yet decoded
+    std::string out;         // Serialized replies waiting to be sent
+    size_t out_offset = 0;   // Bytes of 'out' already written
+    uint64_t out_start = 0;  // Stream position of out[0]: bytes taken off its front so far
+    std::string sending;     // io_uring: replies owned by the in-flight send
+    bool send_inflight = false;
+    bool replied = false;    // Request decoded and reply queued
+    bool peer_closed = false;
+    int pending_ops = 0;     // io_uring requests still referencing this connection
+    bool closing = false;    // io_uring close already queued
+    uint64_t accepted_ns;    // Cleared once the first bytes arrive
+    uint64_t received_ns = 0;    // When the latest bytes arrived
+    uint64_t queued_ns = 0;      // When the oldest unsent reply was queued (0 = none)
+    int queued_type = 0;         // Metrics slot of that reply's request type
+    std::deque<WalReply> wal_replies;  // Queued replies waiting for the WAL, oldest first
+    bool wal_held = false;       // Listed in held_replies
+
+    explicit Connection(int fd) : fd(fd), accepted_ns(monotonic_ns()) {}
+};
+
+// Function to timestamp newly received bytes, and time accept -> first bytes
+void note_received(Connection& conn) {
+    conn.received_ns = monotonic_ns();
+    if (conn.accepted_ns != 0) {
+        server_metrics.local().accept_to_recv.record(conn.received_ns - conn.accepted_ns);
+        conn.accepted_ns = 0;
+    }
+}
+
+// Function to time the send stage once every queued reply has been written.
+// One sample per flush, measured from the oldest reply in it.
+void note_sent(Connection& conn) {
+    if (conn.queued_ns == 0) return;
+    server_metrics.local().stages[STAGE_SEND][conn.queued_type].record(monotonic_ns() - conn.queued_ns);
+    conn.queued_ns = 0;
+}
+
+// Function to tell whether dispatch_request() handles a request type
+bool is_single_request(MessageType type) {
+    return type == REGISTRATION_REQUEST || type == PDU_SESSION_REQUEST || type == DEREGISTRATION_REQUEST;
+}
+
+// Function to apply one request to the shared core and decide its ack
+bool dispatch_request(const ClientMessage& client_msg, Ack& ack) {
+    ack.request_id = client_msg.request_id();  // Correlates pipelined replies
+    ack.pdu_id = 0;
+
+    switch (client_msg.type()) {
+        case REGISTRATION_REQUEST:
+            ack.id = client_msg.reg_req().id();
+            ack.kind = subscriber_core.register_user(ack.id);
+            break;
+
+        case PDU_SESSION_REQUEST: {
+            const PduSessionRequest& req = client_msg.pdu_req();
+            const std::string& sd = req.sd();
+            ack.id = req.id();
+            ack.kind = subscriber_core.pdu_session(ack.id, req.sst(), sd.data(), sd.size(), ack.pdu_id);
+            break;
+        }
+
+        case DEREGISTRATION_REQUEST:
+            ack.id = client_msg.dereg_req().id();
+            ack.kind = subscriber_core.deregister_user(ack.id);
+            break;
+
+        default:
+            server_metrics.local().unknown_types.add();
+            LOG_WARN("Unknown request type: {}", client_msg.type());
+            return false;
+    }
+    return true;
+}
+
+// Per-thread request state. Requests are decoded into a protobuf arena whose
+// block is owned by the I/O thread and reset after every request, and batch
+// acks are collected in a reused vector, so steady-state decode and dispatch
+// never call malloc.
+class RequestContext {
+public:
+    RequestContext() : block_(new char[ARENA_BLOCK_SIZE]), arena_(arena_options(block_.get())) {}
+
+    google::protobuf::Arena* arena() { return &arena_; }
+
+    // Emptied ack list for the items of one batch
+    std::vector<Ack>& batch_acks() {
+        batch_acks_.clear();
+        return batch_acks_;
+    }
+
+    // Releases the arena allocations of the current request when it goes out
+    // of scope; the initial block is kept for the next one
+    struct Scope {
+        google::protobuf::Arena* arena;
+        ~Scope() { arena->Reset(); }
+    };
+
+private:
+    static google::protobuf::ArenaOptions arena_options(char* block) {
+        google::protobuf::ArenaOptions opts;
+        opts.initial_block = block;
+        opts.initial_block_size = ARENA_BLOCK_SIZE;
+        opts.start_block_size = ARENA_BLOCK_SIZE;
+        return opts;
+    }
+
+    std::unique_ptr<char[]> block_;
+    google::protobuf::Arena arena_;
+    std::vector<Ack> batch_acks_;
+};
+
+thread_local RequestContext request_context;
+
+// Function to note that the reply starting at out[start] waits for the WAL.
+// Durable points never decrease, so a reply in an already noted commit group
+// needs no entry of its own.
+void hold_until_durable(Connection& conn, size_t start) {
+    WriteAheadLog* wal = subscriber_core.wal();
+    if (wal == nullptr) return;
+    uint64_t lsn = subscriber_core.durable_point();
+    if (lsn <= wal->durable()) return;
+    if (!conn.wal_replies.empty() && conn.wal_replies.back().lsn >= lsn) return;
+    conn.wal_replies.push_back(WalReply{lsn, conn.out_start + start});
+}
+
+// Function to decode a request or batch, dispatch it and append the encoded
+// reply to the connection's output buffer (whose capacity is reused).
+// 'reply_start' is where the reply, including any frame header, begins in 'out'.
+bool process_request(Connection& conn, const char* data, size_t len, size_t reply_start) {
+    ServerMetricsShard& metrics = server_metrics.local();
+    uint64_t start = monotonic_ns();
+    google::protobuf::Arena* arena = request_context.arena();
+    RequestContext::Scope scope{arena};
+
+    ClientMessage& client_msg = *google::protobuf::Arena::CreateMessage<ClientMessage>(arena);
+    if (!client_msg.ParseFromArray(data, static_cast<int>(len))) {
+        metrics.parse_failures.add();
+        LOG_WARN("Failed to parse client message ({} bytes)", len);
+        return false;
+    }
+    uint64_t parsed = monotonic_ns();
+
+    // Replies are spliced together from the pre-encoded acks in response_cache
+    MessageType type = client_msg.type();
+    int status = 200;  // A batch is answered as a whole
+    uint64_t dispatched;
+    if (type == BATCH_REQUEST) {
+        // The whole batch is applied in one pass and answered with a single
+        // ServerBatch. Every item is checked first, so a batch with an
+        // unknown item is dropped without applying any of it.
+        const ClientBatch& batch = client_msg.batch();
+        for (const ClientMessage& item : batch.messages()) {
+            if (!is_single_request(item.type())) {
+                metrics.unknown_types.add();
+                LOG_WARN("Unknown request type in batch: {}", item.type());
+                return false;
+            }
+        }
+        std::vector<Ack>& acks = request_context.batch_acks();
+        acks.resize(batch.messages_size());
+        for (int i = 0; i < batch.messages_size(); ++i) {
+            if (!dispatch_request(batch.messages(i), acks[i])) {
+                return false;
+            }
+        }
+        dispatched = monotonic_ns();
+        response_cache.append_batch(acks.data(), acks.size(), client_msg.request_id(), conn.out);
+    } else {
+        Ack ack;
+        if (!dispatch_request(client_msg, ack)) {
+            return false;
+        }
+        dispatched = monotonic_ns();
+        status = response_cache.status(ack.kind);
+        response_cache.append(ack, conn.out);
+    }
+    uint64_t encoded = monotonic_ns();
+
+    int slot = type / 2;
+    metrics.requests.add();
+    metrics.stages[STAGE_PARSE][slot].record(parsed - start);
+    metrics.stages[STAGE_DISPATCH][slot].record(dispatched - parsed);
+    metrics.stages[STAGE_SERIALIZE][slot].record(encoded - dispatched);
+    metrics.requests_by_status[slot][metric_status(status)].record(encoded - conn.received_ns);
+    if (conn.queued_ns == 0) {
+        conn.queued_ns = encoded;
+        conn.queued_type = slot;
+    }
+    hold_until_durable(conn, reply_start);
+    return true;
+}
+
+// Connections of this I/O thread whose replies wait for a WAL commit, and the
+// eventfd the commit signals
+struct HeldReplies {
+    WalWaker waker;
+    uint64_t wake_count = 0;               // io_uring: target of the eventfd read
+    std::vector<Connection*> connections;
+    std::vector<Connection*> ready;        // Scratch for release_held_replies()
+};
+
+thread_local HeldReplies held_replies;
+
+// Function to create this thread's eventfd and register it with the WAL.
+// Returns false if there is no WAL.
+bool init_held_replies() {
+    WriteAheadLog* wal = subscriber_core.wal();
+    if (wal == nullptr) return false;
+    held_replies.waker.fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (held_replies.waker.fd < 0) {
+        perror("eventfd failed");
+        exit(EXIT_FAILURE);  // Replies would never be released
+    }
+    wal->add_waker(&held_replies.waker);
+    return true;
+}
+
+// Function to drop the replies whose changes the WAL has synced
+void drop_durable_replies(Connection& conn, uint64_t durable) {
+    while (!conn.wal_replies.empty() && conn.wal_replies.front().lsn <= durable) {
+        conn.wal_replies.pop_front();
+    }
+}
+
+// Function to return the WAL record the oldest waiting reply needs (0 = none)
+uint64_t oldest_wal_reply(const Connection& conn) {
+    return conn.wal_replies.empty() ? 0 : conn.wal_replies.front().lsn;
+}
+
+// Function to find how much of 'out' may be sent: every reply before the
+// oldest one the WAL has not synced yet. If one still waits, the connection
+// is held until a commit signals this thread. Returns a length from out[0].
+size_t sendable_bytes(Connection& conn) {
+    if (conn.wal_replies.empty()) return conn.out.size();
+    WriteAheadLog* wal = subscriber_core.wal();
+    drop_durable_replies(conn, wal->durable());
+    if (conn.wal_replies.empty()) return conn.out.size();
+    held_replies.waker.armed.store(true);
+    drop_durable_replies(conn, wal->durable());  // Committed meanwhile
+    if (conn.wal_replies.empty()) return conn.out.size();
+    if (!conn.wal_held) {
+        conn.wal_held = true;
+        ++conn.pending_ops;  // io_uring: keeps the connection alive
+        held_replies.connections.push_back(&conn);
+    }
+    return conn.wal_replies.front().start - conn.out_start;
+}
+
+// Function to drop a connection that is being closed from the held list
+void forget_held_reply(Connection& conn) {
+    if (!conn.wal_held) return;
+    std::vector<Connection*>& held = held_replies.connections;
+    held.erase(std::find(held.begin(), held.end(), &conn));
+    conn.wal_held = false;
+    --conn.pending_ops;
+}
+
+// Function to call release(conn) for every held connection whose oldest
+// waiting reply is now durable, after a commit signalled this thread's eventfd
+template <typename Release>
+void release_held_replies(Release release) {
+    WriteAheadLog* wal = subscriber_core.wal();
+    std::vector<Connection*>& held = held_replies.connections;
+    std::vector<Connection*>& ready = held_replies.ready;
+    while (!held.empty()) {
+        uint64_t durable = wal->durable();
+        auto waiting = std::partition(held.begin(), held.end(),
+                                      [&](Connection* conn) { return oldest_wal_reply(*conn) > durable; });
+        ready.assign(waiting, held.end());
+        held.erase(waiting, held.end());
+        for (Connection* conn : ready) {
+            conn->wal_held = false;
+            --conn->pending_ops;
+            release(conn);
+        }
+        if (held.empty()) break;
+        held_replies.waker.armed.store(true);
+        if (oldest_wal_reply(*held.front()) > wal->durable()) break;  // Next commit signals again
+    }
+}
+
+// Framed mode: decode every complete frame buffered on the connection and
+// queue one framed reply per request, so clients may pipeline requests.
+// The connection stays open until EOF.
+bool handle_framed_client(Connection& conn) {
+    size_t offset = 0;
+    const char* payload;
+    size_t len;
+    int status;
+    while ((status = next_frame(conn.in, offset, payload, len)) > 0) {
+        size_t header = begin_frame(conn.out);
+        if (!process_request(conn, payload, len, header)) {
+            return false;
+        }
+        end_frame(conn.out, header);
+        offset += FRAME_HEADER_SIZE + len;
+    }
+    if (status < 0) {
+        server_metrics.local().oversized_frames.add();
+        LOG_WARN("Frame exceeds {} bytes", MAX_FRAME_SIZE);
+        return false;
+    }
+    conn.in.erase(0, offset);
+    return true;
+}
+
+// Function to handle client requests: once the socket is drained, decode the
+// buffered request(s) and queue the reply. Returns false to drop the connection.
+bool handle_client(Connection& conn) {
+    if (server_options.framed) {
+        return handle_framed_client(conn);
+    }
+    if (conn.replied) {
+        return true;
+    }
+    if (conn.in.empty()) {
+        if (conn.peer_closed) {
+            LOG_WARN("Failed to receive data or connection closed");
+            return false;
+        }
+        return true;
+    }
+    if (!process_request(conn, conn.in.data(), conn.in.size(), conn.out.size())) {
+        return false;
+    }
+    conn.in.clear();
+    conn.replied = true;
+    return true;
+}
+
+// Reads everything currently available. Returns false on a socket error.
+bool drain_socket(Connection& conn) {
+    char buffer[READ_CHUNK];
+    bool received = false;
+    while (true) {
+        ssize_t n = recv(conn.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            if (!received) {
+                note_received(conn);
+                received = true;
+            }
+            conn.in.append(buffer, n);
+        } else if (n == 0) {
+            conn.peer_closed = true;
+            return true;
+        } else if (errno == EINTR) {
+            continue;
+        } else {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+    }
+}
+
+// Writes as much of the pending replies as the socket accepts, up to the
+// first one still waiting for the WAL. Returns false on a socket error.
+bool flush_socket(Connection& conn) {
+    size_t end = sendable_bytes(conn);
+    while (conn.out_offset < end) {
+        ssize_t n = send(conn.fd, conn.out.data() + conn.out_offset,
+                         end - conn.out_offset, MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.out_offset += n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+    bool flushed = conn.out_offset == conn.out.size();
+    if (server_options.framed) {
+        // Drop what was sent; held replies stay queued for the next commit
+        conn.out.erase(0, conn.out_offset);
+        conn.out_start += conn.out_offset;
+        conn.out_offset = 0;
+    }
+    if (flushed) note_sent(conn);
+    return true;
+}
+
+void close_connection(int epoll_fd, Connection* conn) {
+    forget_held_reply(*conn);
+    server_metrics.local().connections_closed.add();
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, conn->fd, nullptr);
+    close(conn->fd);
+    delete conn;
+}
+
+// Accepts every pending connection and registers it with this thread's epoll set
+void accept_connections(int server_fd, int epoll_fd) {
+    while (true) {
+        int client_socket = accept4(server_fd, nullptr, nullptr, SOCK_NONBLOCK);
+        if (client_socket < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) LOG_ERROR("Accept failed: {}", strerror(errno));
+            return;
+        }
+
+        Connection* conn = new Connection(client_socket);
+        server_metrics.local().connections_accepted.add();
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = conn;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client_socket, &ev) < 0) {
+            LOG_ERROR("epoll_ctl failed: {}", strerror(errno));
+            server_metrics.local().connections_closed.add();
+            close(client_socket);
+            delete conn;
+        }
+    }
+}
+
+// Event loop run by every I/O thread. Each thread owns an epoll set and its
+// connections. The listening socket is either shared with EPOLLEXCLUSIVE so
+// only one thread is woken per incoming connection, or (with SO_REUSEPORT)
+// private to this thread and load-balanced by the kernel.
+void io_loop(int server_fd) {
+    int epoll_fd = epoll_create1(0);
+    if (epoll_fd < 0) {
+        perror("epoll_create1 failed");
+        return;
+    }
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+    ev.data.ptr = nullptr;  // nullptr marks the listening socket
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server_fd, &ev) < 0) {
+        perror("epoll_ctl failed");
+        close(epoll_fd);
+        return;
+    }
+
+    // The WAL's eventfd is marked by a pointer to this thread's waker
+    if (init_held_replies()) {
+        ev.events = EPOLLIN;
+        ev.data.ptr = &held_replies.waker;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, held_replies.waker.fd, &ev) < 0) {
+            perror("epoll_ctl failed");
+            close(epoll_fd);
+            return;
+        }
+    }
+
+    // Function to send the pending replies and close the connection on error
+    // or once it is done.
+    // Legacy protocol: one request, one reply, then close.
+    // Framed protocol: close once the peer is done and replies are out.
+    auto finish = [&](Connection* conn) {
+        bool ok = flush_socket(*conn);
+        bool flushed = conn->out_offset == conn->out.size();
+        bool done = flushed && (server_options.framed ? conn->peer_closed : conn->replied);
+        if (!ok || done) {
+            close_connection(epoll_fd, conn);
+        }
+    };
+
+    std::vector<struct epoll_event> events(MAX_EVENTS);
+    while (true) {
+        int n = epoll_wait(epoll_fd, events.data(), MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait failed");
+            break;
+        }
+
+        bool committed = false;  // The WAL released held replies
+        for (int i = 0; i < n; ++i) {
+            Connection* conn = static_cast<Connection*>(events[i].data.ptr);
+            if (conn == nullptr) {
+                accept_connections(server_fd, epoll_fd);
+                continue;
+            }
+            if (events[i].data.ptr == &held_replies.waker) {
+                uint64_t count;
+                (void)!read(held_replies.waker.fd, &count, sizeof(count));
+                committed = true;
+                continue;
+            }
+
+            bool ok = !(events[i].events & EPOLLERR);
+            if (ok && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))) {
+                ok = drain_socket(*conn) && handle_client(*conn);
+            }
+            if (ok) {
+                finish(conn);
+            } else {
+                close_connection(epoll_fd, conn);
+            }
+        }
+        // After the batch, as releasing may close connections it still names
+        if (committed) {
+            release_held_replies(finish);
+        }
+    }
+    close(epoll_fd);
+}
+
+// io_uring engine. Completions carry the Connection pointer with the
+// operation kind packed into its (always zero) low bits.
+enum UringOp : uintptr_t { URING_ACCEPT, URING_RECV, URING_SEND, URING_SHUTDOWN, URING_CLOSE, URING_WAL };
+#define URING_OP_MASK 0x7
+
+uint64_t uring_tag(Connection* conn, UringOp op) {
+    return reinterpret_cast<uintptr_t>(conn) | op;
+}
+
+// Operations that found the submission queue full, queued until the next
+// reap frees it. Each one counts as a pending op of its connection.
+thread_local std::vector<std::pair<Connection*, std::function<void(IoUring&)>>> uring_deferred;
+
+// Function to make room for count SQEs. Returns false after queueing retry
+// to run once completions have been reaped.
+bool uring_reserve(IoUring& ring, unsigned count, Connection* conn, std::function<void(IoUring&)> retry) {
+    if (ring.reserve(count)) return true;
+    if (conn != nullptr) ++conn->pending_ops;
+    uring_deferred.emplace_back(conn, std::move(retry));
+    return false;
+}
+
+// Function to free a closing connection once no request references it
+void uring_release(Connection* conn) {
+    if (conn != nullptr && conn->closing && conn->pending_ops == 0) {
+        server_metrics.local().connections_closed.add();
+        delete conn;
+    }
+}
+
+// Function to retry the operations queued while the submission queue was full
+void uring_run_deferred(IoUring& ring) {
+    std::vector<std::pair<Connection*, std::function<void(IoUring&)>>> deferred;
+    deferred.swap(uring_deferred);
+    for (auto& op : deferred) {
+        if (op.first != nullptr) --op.first->pending_ops;
+        op.second(ring);
+        uring_release(op.first);
+    }
+}
+
+void uring_arm_accept(IoUring& ring, int server_fd) {
+    if (!uring_reserve(ring, 1, nullptr, [server_fd](IoUring& r) { uring_arm_accept(r, server_fd); })) return;
+    struct io_uring_sqe* sqe = ring.get_sqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = server_fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = uring_tag(nullptr, URING_ACCEPT);
+}
+
+void uring_arm_recv(IoUring& ring, Connection* conn) {
+    if (conn->closing) return;
+    if (!uring_reserve(ring, 1, conn, [conn](IoUring& r) { uring_arm_recv(r, conn); })) return;
+    struct io_uring_sqe* sqe = ring.get_sqe();
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conn->fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = ring.buffer_group();
+    sqe->user_data = uring_tag(conn, URING_RECV);
+    ++conn->pending_ops;
+}
+
+// Waits for the next WAL commit signal on this thread's eventfd
+void uring_arm_wal(IoUring& ring) {
+    if (!uring_reserve(ring, 1, nullptr, [](IoUring& r) { uring_arm_wal(r); })) return;
+    struct io_uring_sqe* sqe = ring.get_sqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = held_replies.waker.fd;
+    sqe->addr = reinterpret_cast<uintptr_t>(&held_replies.wake_count);
+    sqe->len = sizeof(held_replies.wake_count);
+    sqe->user_data = uring_tag(nullptr, URING_WAL);
+}
+
+// Queues the linked chain of uring_send_and_close, all SQEs or none
+void uring_queue_close(IoUring& ring, Connection* conn, bool send_reply) {
+    auto retry = [conn, send_reply](IoUring& r) { uring_queue_close(r, conn, send_reply); };
+    if (!uring_reserve(ring, send_reply ? 3 : 2, conn, retry)) return;
+    if (send_reply) {
+        struct io_uring_sqe* sqe = ring.get_sqe();
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = conn->fd;
+        sqe->addr = reinterpret_cast<uintptr_t>(conn->out.data() + conn->out_offset);
+        sqe->len = static_cast<uint32_t>(conn->out.size() - conn->out_offset);
+        sqe->msg_flags = MSG_WAITALL | MSG_NOSIGNAL;
+        sqe->flags = IOSQE_IO_LINK;
+        sqe->user_data = uring_tag(conn, URING_SEND);
+        ++conn->pending_ops;
+    }
+
+    struct io_uring_sqe* sqe = ring.get_sqe();
+    sqe->opcode = IORING_OP_SHUTDOWN;
+    sqe->fd = conn->fd;
+    sqe->len = SHUT_RDWR;
+    sqe->flags = IOSQE_IO_LINK | IOSQE_CQE_SKIP_SUCCESS;
+    sqe->user_data = uring_tag(conn, URING_SHUTDOWN);
+
+    sqe = ring.get_sqe();
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->fd = conn->fd;
+    sqe->user_data = uring_tag(conn, URING_CLOSE);
+    ++conn->pending_ops;
+}
+
+// Queues shutdown+close, optionally linked behind a send of the pending reply.
+// The shutdown also terminates the connection's multishot recv.
+void uring_send_and_close(IoUring& ring, Connection* conn, bool send_reply) {
+    forget_held_reply(*conn);
+    conn->closing = true;
+    uring_queue_close(ring, conn, send_reply);
+}
+
+// Framed mode: sends the replies queued since the last send. Only one send
+// is in flight per connection so the kernel never sees a reallocated buffer.
+void uring_send(IoUring& ring, Connection* conn) {
+    if (conn->closing || conn->send_inflight || conn->out.empty()) return;
+    size_t end = sendable_bytes(*conn);
+    if (end == 0) return;
+    if (!uring_reserve(ring, 1, conn, [conn](IoUring& r) { uring_send(r, conn); })) return;
+    if (end == conn->out.size()) {
+        conn->sending.swap(conn->out);
+        conn->out.clear();
+    } else {
+        conn->sending.assign(conn->out, 0, end);  // The rest waits for the WAL
+        conn->out.erase(0, end);
+    }
+    conn->out_start += end;
+
+    struct io_uring_sqe* sqe = ring.get_sqe();
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = conn->fd;
+    sqe->addr = reinterpret_cast<uintptr_t>(conn->sending.data());
+    sqe->len = static_cast<uint32_t>(conn->sending.size());
+    sqe->msg_flags = MSG_WAITALL | MSG_NOSIGNAL;
+    sqe->user_data = uring_tag(conn, URING_SEND);
+    conn->send_inflight = true;
+    ++conn->pending_ops;
+}
+
+// Legacy protocol: sends the one reply, once durable, then closes
+void uring_reply_and_close(IoUring& ring, Connection* conn) {
+    if (sendable_bytes(*conn) == conn->out.size()) uring_send_and_close(ring, conn, true);
+}
+
+// Framed mode: closes once the peer is done and every reply is sent
+void uring_close_if_done(IoUring& ring, Connection* conn) {
+    if (conn->peer_closed && !conn->send_inflight && !conn->wal_held && conn->out.empty()) {
+        uring_send_and_close(ring, conn, false);
+    }
+}
+
+void uring_handle_completion(IoUring& ring, int server_fd, const struct io_uring_cqe& cqe) {
+    Connection* conn = reinterpret_cast<Connection*>(cqe.user_data & ~static_cast<uint64_t>(URING_OP_MASK));
+    bool more = cqe.flags & IORING_CQE_F_MORE;
+
+    switch (static_cast<UringOp>(cqe.user_data & URING_OP_MASK)) {
+        case URING_ACCEPT:
+            if (cqe.res >= 0) {
+                server_metrics.local().connections_accepted.add();
+                uring_arm_recv(ring, new Connection(cqe.res));
+            } else if (cqe.res != -EINTR && cqe.res != -ECONNABORTED) {
+                LOG_ERROR("Accept failed: {}", strerror(-cqe.res));
+            }
+            if (!more) uring_arm_accept(ring, server_fd);
+            return;
+
+        case URING_WAL:
+            release_held_replies([&](Connection* held) {
+                if (server_options.framed) {
+                    uring_send(ring, held);
+                    uring_close_if_done(ring, held);
+                } else {
+                    uring_reply_and_close(ring, held);
+                }
+            });
+            uring_arm_wal(ring);
+            return;
+
+        case URING_RECV: {
+            if (!more) --conn->pending_ops;
+            if (cqe.flags & IORING_CQE_F_BUFFER) {
+                uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                if (cqe.res > 0) {
+                    note_received(*conn);
+                    conn->in.append(ring.buffer(bid), cqe.res);
+                }
+                ring.recycle_buffer(bid);
+            }
+            if (conn->closing) break;
+
+            if (cqe.res == 0) {
+                conn->peer_closed = true;
+            } else if (cqe.res < 0 && cqe.res != -ENOBUFS) {
+                uring_send_and_close(ring, conn, false);
+                break;
+            }
+            if (!handle_client(*conn)) {
+                uring_send_and_close(ring, conn, false);
+            } else if (server_options.framed) {
+                uring_send(ring, conn);
+                if (conn->peer_closed) {
+                    uring_close_if_done(ring, conn);
+                } else if (!more) {
+                    uring_arm_recv(ring, conn);
+                }
+            } else if (conn->replied) {
+                // Legacy protocol: one request, one reply, then close
+                if (!conn->wal_held) uring_reply_and_close(ring, conn);
+            } else if (conn->peer_closed) {
+                uring_send_and_close(ring, conn, false);
+            } else if (!more) {
+                uring_arm_recv(ring, conn);  // Buffer ring ran dry; re-arm
+            }
+            break;
+        }
+
+        case URING_SEND:
+            --conn->pending_ops;
+            if (!server_options.framed && cqe.res >= 0) note_sent(*conn);  // MSG_WAITALL: all or error
+            if (!server_options.framed || conn->closing) break;
+            conn->send_inflight = false;
+            if (cqe.res < 0) {
+                uring_send_and_close(ring, conn, false);
+                break;
+            }
+            conn->sending.erase(0, cqe.res);
+            if (conn->sending.empty()) {
+                note_sent(*conn);
+            } else {
+                conn->out.insert(0, conn->sending);  // Short send: resend the rest first
+                conn->out_start -= conn->sending.size();
+                conn->sending.clear();
+            }
+            uring_send(ring, conn);
+            uring_close_if_done(ring, conn);
+            break;
+
+        case URING_SHUTDOWN:
+            break;  // Only reported on failure; the linked close is then cancelled
+
+        case URING_CLOSE:
+            --conn->pending_ops;
+            if (cqe.res < 0) {
+                // The linked chain was cut short (failed send); close directly
+                shutdown(conn->fd, SHUT_RDWR);
+                close(conn->fd);
+            }
+            break;
+    }
+
+    uring_release(conn);
+}
+
+// Event loop of the io_uring engine: multishot accept, multishot recv into
+// provided buffers and linked send+shutdown+close, so a whole request costs a
+// handful of SQEs and most wakeups batch many completions into one syscall.
+void uring_loop(int server_fd) {
+    IoUring ring;
+    if (!ring.init(URING_ENTRIES) || !ring.setup_buffer_ring(0, URING_BUFFERS, READ_CHUNK)) {
+        std::cerr << "io_uring setup failed, falling back to epoll\n";
+        io_loop(server_fd);
+        return;
+    }
+
+    uring_arm_accept(ring, server_fd);
+    if (init_held_replies()) uring_arm_wal(ring);
+    while (true) {
+        int ret = ring.submit(1);
+        if (ret < 0 && ret != -EBUSY) {
+            std::cerr << "io_uring_enter failed: " << strerror(-ret) << "\n";
+            break;
+        }
+        ring.for_each_cqe([&](const struct io_uring_cqe& cqe) {
+            uring_handle_completion(ring, server_fd, cqe);
+        });
+        if (!uring_deferred.empty()) uring_run_deferred(ring);
+    }
+}
+
+// Function to create a bound, listening, non-blocking socket
+int create_listener(const ServerOptions& options) {
+    int server_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (server_fd == -1) {
+        perror("Socket creation failed");
+        return -1;
+    }
+
+    // Lets a restarted server bind while the old connections sit in TIME_WAIT
+    int enable = 1;
+    if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) < 0) {
+        perror("SO_REUSEADDR failed");
+        close(server_fd);
+        return -1;
+    }
+    if (options.reuse_port &&
+        setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+        perror("SO_REUSEPORT failed");
+        close(server_fd);
+        return -1;
+    }
+
+    struct sockaddr_in address;
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(options.port);
+
+    if (bind(server_fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        perror("Bind failed");
+        close(server_fd);
+        return -1;
+    }
+
+    if (listen(server_fd, options.backlog) < 0) {
+        perror("Listen failed");
+        close(server_fd);
+        return -1;
+    }
+    return server_fd;
+}
+
+// Function to pin a thread to one CPU, round-robin over the available CPUs
+void pin_thread(std::thread& t, int index) {
+    cpu_set_t available;
+    CPU_ZERO(&available);
+    if (sched_getaffinity(0, sizeof(available), &available) != 0) return;
+
+    int cpu_count = CPU_COUNT(&available);
+    int target = index % cpu_count;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &available)) continue;
+        if (target-- == 0) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            pthread_setaffinity_np(t.native_handle(), sizeof(set), &set);
+            return;
+        }
+    }
+}
+
+// Function to render the counters and every non-empty histogram, summed over
+// the I/O threads
+std::string metrics_report() {
+    static const char* const stage_names[] = {"parse", "dispatch", "serialize", "send"};
+    static const char* const status_names[] = {"200", "400", "403", "409", "other"};
+
+    uint64_t accepted = 0, closed = 0, requests = 0, parse_failures = 0, unknown_types = 0, oversized = 0;
+    server_metrics.for_each([&](const ServerMetricsShard& shard) {
+        accepted += shard.connections_accepted.get();
+        closed += shard.connections_closed.get();
+        requests += shard.requests.get();
+        parse_failures += shard.parse_failures.get();
+        unknown_types += shard.unknown_types.get();
+        oversized += shard.oversized_frames.get();
+    });
+
+    std::ostringstream counters;
+    counters << "# uptime_seconds " << (monotonic_ns() - server_start_ns) / 1000000000ull << "\n"
+             << "connections_accepted " << accepted << "\n"
+             << "connections_open " << accepted - closed << "\n"
+             << "requests " << requests << "\n"
+             << "parse_failures " << parse_failures << "\n"
+             << "unknown_types " << unknown_types << "\n"
+             << "oversized_frames " << oversized << "\n";
+    std::string out = counters.str();
+    out += subscriber_core.metrics_report();
+    out += LATENCY_HEADER;
+
+    // Sums one histogram over all shards and appends it if non-empty
+    std::unique_ptr<HistogramSnapshot> snapshot(new HistogramSnapshot());
+    auto append_histogram = [&](const std::string& label, auto histogram_of) {
+        *snapshot = HistogramSnapshot();
+        server_metrics.for_each([&](const ServerMetricsShard& shard) { histogram_of(shard).add_to(*snapshot); });
+        if (snapshot->count > 0) append_latency_line(out, label, *snapshot);
+    };
+
+    append_histogram("accept_to_recv", [](const ServerMetricsShard& shard) -> const LatencyHistogram& {
+        return shard.accept_to_recv;
+    });
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        for (int slot = 0; slot < METRIC_REQUEST_TYPES; ++slot) {
+            std::string label = std::string(stage_names[stage]) + " " +
+                                MessageType_Name(static_cast<MessageType>(slot * 2));
+            append_histogram(label, [=](const ServerMetricsShard& shard) -> const LatencyHistogram& {
+                return shard.stages[stage][slot];
+            });
+        }
+    }
+    for (int slot = 0; slot < METRIC_REQUEST_TYPES; ++slot) {
+        for (int status = 0; status < METRIC_STATUSES; ++status) {
+            std::string label = "request " + MessageType_Name(static_cast<MessageType>(slot * 2)) + " " +
+                                status_names[status];
+            append_histogram(label, [=](const ServerMetricsShard& shard) -> const LatencyHistogram& {
+                return shard.requests_by_status[slot][status];
+            });
+        }
+    }
+    return out;
+}
+
+// Admin endpoint: answers every connection on 127.0.0.1:port with the metrics
+// report as a plain-text HTTP response (e.g. curl http://127.0.0.1:port/metrics)
+void admin_loop(int port) {
+    int admin_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (admin_fd < 0) {
+        perror("Admin socket creation failed");
+        return;
+    }
+    int enable = 1;
+    setsockopt(admin_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    struct sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    if (bind(admin_fd, (struct sockaddr*)&address, sizeof(address)) < 0 || listen(admin_fd, 16) < 0) {
+        perror("Admin port bind failed");
+        close(admin_fd);
+        return;
+    }
+
+    while (true) {
+        int client = accept(admin_fd, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            perror("Admin accept failed");
+            break;
+        }
+        // Consume the request line; its content is not needed
+        struct timeval timeout = {1, 0};
+        setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        char request[1024];
+        (void)!recv(client, request, sizeof(request), 0);
+
+        std::string body = metrics_report();
+        std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain\r\nContent-Length: " +
+                               std::to_string(body.size()) + "\r\n\r\n" + body;
+        size_t sent = 0;
+        while (sent < response.size()) {
+            ssize_t n = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) break;
+            sent += static_cast<size_t>(n);
+        }
+        close(client);
+    }
+    close(admin_fd);
+}
+
+// Function to write the metrics report to stdout every 'seconds' seconds
+void metrics_dump_loop(int seconds) {
+    while (true) {
+        std::this_thread::sleep_for(std::chrono::seconds(seconds));
+        std::string report = metrics_report();
+        (void)!write(STDOUT_FILENO, report.data(), report.size());
+    }
+}
+
+// Function to open the listener(s) and start the I/O threads. Returns false
+// if a listener could not be created.
+bool start_tcp_server(ServerOptions& options, std::vector<int>& listeners, std::vector<std::thread>& io_threads) {
+    if (options.io_uring && !IoUring::supported()) {
+        std::cerr << "Kernel lacks io_uring multishot support, falling back to epoll\n";
+        options.io_uring = false;
+    }
+
+    // One shared listener, or one SO_REUSEPORT listener per I/O thread
+    int listener_count = options.reuse_port ? options.io_threads : 1;
+    for (int i = 0; i < listener_count; ++i) {
+        int server_fd = create_listener(options);
+        if (server_fd < 0) {
+            for (int fd : listeners) close(fd);
+            listeners.clear();
+            return false;
+        }
+        listeners.push_back(server_fd);
+    }
+
+    std::cout << "Server listening on port " << options.port << " with "
+              << options.io_threads << " I/O thread(s)"
+              << (options.reuse_port ? " (SO_REUSEPORT)" : "")
+              << " using " << (options.io_uring ? "io_uring" : "epoll")
+              << (options.framed ? ", framed persistent connections" : "")
+              << ", " << options.store << " store"
+              << (options.wal_path.empty() ? "" : ", write-ahead log " + options.wal_path) << "..." << std::endl;
+
+    server_start_ns = monotonic_ns();
+    if (options.admin_port > 0) {
+        std::thread(admin_loop, options.admin_port).detach();
+    }
+    if (options.metrics_interval > 0) {
+        std::thread(metrics_dump_loop, options.metrics_interval).detach();
+    }
+
+    // Fixed pool of event-loop threads instead of a thread per connection
+    for (int i = 0; i < options.io_threads; ++i) {
+        io_threads.emplace_back(options.io_uring ? uring_loop : io_loop, listeners[i % listeners.size()]);
+        if (options.pin_threads) {
+            pin_thread(io_threads.back(), i);
+        }
+    }
+    return true;
+}
+
+#endif // TCP_SERVER_H
@@ -0,0 +1,243 @@
+// Minimal io_uring wrapper built directly on the kernel ABI (no liburing):
+// one submission/completion ring plus a provided-buffer ring for recv.
+#ifndef URING_H
+#define URING_H
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+class IoUring {
+public:
+    IoUring() = default;
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    ~IoUring() {
+        if (buf_ring_ != nullptr) {
+            struct io_uring_buf_reg reg;
+            std::memset(&reg, 0, sizeof(reg));
+            reg.bgid = buf_group_;
+            syscall(__NR_io_uring_register, ring_fd_, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+            munmap(buf_ring_, buf_count_ * sizeof(struct io_uring_buf));
+            std::free(buffers_);
+        }
+        if (sqes_ != nullptr) munmap(sqes_, sqes_size_);
+        if (ring_ != nullptr) munmap(ring_, ring_size_);
+        if (ring_fd_ >= 0) close(ring_fd_);
+    }
+
+    // Sets up the rings. Returns false if the kernel lacks io_uring.
+    bool init(unsigned entries) {
+        struct io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        ring_fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ring_fd_ < 0) return false;
+        if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+            return false;
+        }
+
+        size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        ring_size_ = sq_size > cq_size ? sq_size : cq_size;
+        void* ring = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+        if (ring == MAP_FAILED) return false;
+        ring_ = static_cast<char*>(ring);
+
+        sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+        void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return false;
+        sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+        sq_head_ = reinterpret_cast<unsigned*>(ring_ + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(ring_ + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(ring_ + params.sq_off.ring_mask);
+        sq_entries_ = params.sq_entries;
+        cq_head_ = reinterpret_cast<unsigned*>(ring_ + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(ring_ + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(ring_ + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<struct io_uring_cqe*>(ring_ + params.cq_off.cqes);
+
+        // SQ slot i always holds SQE i, so the index array is filled once
+        unsigned* sq_array = reinterpret_cast<unsigned*>(ring_ + params.sq_off.array);
+        for (unsigned i = 0; i < sq_entries_; ++i) sq_array[i] = i;
+        local_tail_ = *sq_tail_;
+        return true;
+    }
+
+    // Registers 'count' (power of two) recv buffers of 'size' bytes as group 'group'
+    bool setup_buffer_ring(uint16_t group, unsigned count, unsigned size) {
+        size_t ring_bytes = count * sizeof(struct io_uring_buf);
+        void* ring = mmap(nullptr, ring_bytes, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ring == MAP_FAILED) return false;
+
+        struct io_uring_buf_reg reg;
+        std::memset(&reg, 0, sizeof(reg));
+        reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+        reg.ring_entries = count;
+        reg.bgid = group;
+        if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+            munmap(ring, ring_bytes);
+            return false;
+        }
+
+        buf_ring_ = static_cast<struct io_uring_buf_ring*>(ring);
+        buf_group_ = group;
+        buf_count_ = count;
+        buf_size_ = size;
+        buffers_ = static_cast<char*>(std::malloc(static_cast<size_t>(count) * size));
+        buf_tail_ = 0;
+        for (unsigned bid = 0; bid < count; ++bid) {
+            add_buffer(static_cast<uint16_t>(bid));
+        }
+        publish_buffers();
+        return true;
+    }
+
+    char* buffer(uint16_t bid) const { return buffers_ + static_cast<size_t>(bid) * buf_size_; }
+    unsigned buffer_size() const { return buf_size_; }
+    uint16_t buffer_group() const { return buf_group_; }
+
+    // Hands a consumed recv buffer back to the kernel
+    void recycle_buffer(uint16_t bid) {
+        add_buffer(bid);
+        publish_buffers();
+    }
+
+    // Makes room for count SQEs, flushing pending submissions if needed.
+    // Returns false if the kernel would not take them (e.g. -EBUSY while the
+    // completion queue overflows); reaping completions frees the queue again.
+    bool reserve(unsigned count) {
+        if (sq_entries_ - (local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE)) >= count) return true;
+        submit(0);
+        return sq_entries_ - (local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE)) >= count;
+    }
+
+    // Returns a zeroed SQE, or nullptr if the queue is full (see reserve)
+    struct io_uring_sqe* get_sqe() {
+        if (!reserve(1)) return nullptr;
+        struct io_uring_sqe* sqe = &sqes_[local_tail_ & sq_mask_];
+        std::memset(sqe, 0, sizeof(*sqe));
+        ++local_tail_;
+        return sqe;
+    }
+
+    // Submits queued SQEs and optionally waits for completions (one syscall)
+    int submit(unsigned wait_nr) {
+        __atomic_store_n(sq_tail_, local_tail_, __ATOMIC_RELEASE);
+        unsigned to_submit = local_tail_ - submitted_;
+        while (true) {
+            int ret = static_cast<int>(syscall(__NR_io_uring_enter, ring_fd_, to_submit, wait_nr,
+                                               wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0));
+            if (ret >= 0) {
+                submitted_ += static_cast<unsigned>(ret);
+                return ret;
+            }
+            if (errno != EINTR) return -errno;
+        }
+    }
+
+    // Calls fn(cqe) for every available completion and marks them consumed
+    template <typename Fn>
+    unsigned for_each_cqe(Fn fn) {
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        unsigned seen = 0;
+        for (; head != tail; ++head, ++seen) {
+            fn(cqes_[head & cq_mask_]);
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+        return seen;
+    }
+
+    // Checks that the running kernel supports multishot recv with provided
+    // buffers, which is the newest feature the server depends on (Linux 6.0).
+    static bool supported() {
+        IoUring ring;
+        if (!ring.init(8) || !ring.setup_buffer_ring(0, 8, 64)) return false;
+
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) return false;
+        struct io_uring_sqe* sqe = ring.get_sqe();
+        if (sqe == nullptr) {
+            close(fds[0]);
+            close(fds[1]);
+            return false;
+        }
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = fds[0];
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = 0;
+        ring.submit(0);
+        (void)!write(fds[1], "x", 1);
+
+        int result = -EINVAL;
+        bool armed = false;
+        ring.submit(1);
+        ring.for_each_cqe([&](const struct io_uring_cqe& cqe) {
+            result = cqe.res;
+            armed = cqe.flags & IORING_CQE_F_MORE;
+        });
+        close(fds[1]);
+        shutdown(fds[0], SHUT_RDWR);
+        if (armed) {
+            ring.submit(1);  // Wait for the multishot recv to terminate
+            ring.for_each_cqe([](const struct io_uring_cqe&) {});
+        }
+        close(fds[0]);
+        return result == 1;
+    }
+
+private:
+    void add_buffer(uint16_t bid) {
+        // Index the ring directly: in C++ the kernel header's flexible-array
+        // wrapper shifts 'bufs' by the size of an empty struct.
+        struct io_uring_buf* buf = reinterpret_cast<struct io_uring_buf*>(buf_ring_) +
+                                   (buf_tail_ & (buf_count_ - 1));
+        buf->addr = reinterpret_cast<uint64_t>(buffer(bid));
+        buf->len = buf_size_;
+        buf->bid = bid;
+        ++buf_tail_;
+    }
+
+    void publish_buffers() {
+        __atomic_store_n(&buf_ring_->tail, buf_tail_, __ATOMIC_RELEASE);
+    }
+
+    int ring_fd_ = -1;
+    char* ring_ = nullptr;
+    size_t ring_size_ = 0;
+    struct io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned local_tail_ = 0;
+    unsigned submitted_ = 0;
+
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    struct io_uring_cqe* cqes_ = nullptr;
+
+    struct io_uring_buf_ring* buf_ring_ = nullptr;
+    char* buffers_ = nullptr;
+    uint16_t buf_group_ = 0;
+    unsigned buf_count_ = 0;
+    unsigned buf_size_ = 0;
+    uint16_t buf_tail_ = 0;
+};
+
+#endif // URING_H
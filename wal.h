@@ -0,0 +1,436 @@
+// Write-ahead log of the core's state changes (subscriber_core.h), so
+// registrations and PDU sessions survive a restart. Every change is one
+// fixed-size, checksummed record appended to an in-memory group; a flusher
+// thread writes the group and fdatasync()s it once, so concurrent requests
+// share one sync (group commit). The flusher waits up to the commit budget
+// after a group's first record for more to join it. Records are numbered
+// (the LSN) in file order; durable() is the LSN of the last synced one.
+// Front-ends never block on the log: they hold a reply until durable()
+// covers its request, woken by a WalWaker eventfd (event loops) or a
+// callback run by the flusher (defer()).
+// The file starts with a header naming the LSN before its first record.
+// Snapshots (snapshot.h) keep it short: roll() moves the records so far to
+// PATH.prev and starts PATH afresh, and drop_previous() deletes PATH.prev
+// once a snapshot covers it. At startup PATH.prev and PATH are read back and
+// every record after the snapshot's LSN handed to the core; a torn or corrupt
+// tail (e.g. from a crash mid-write) is cut off.
+#ifndef WAL_H
+#define WAL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include "checksum.h"
+#include "logger.h"
+
+#define WAL_DEFAULT_COMMIT_US 200          // Default commit budget
+#define WAL_MAX_GROUP_BYTES (1 << 20)      // A group this large is committed without waiting
+#define WAL_READ_CHUNK (64 * 1024)         // Bytes read per call during replay
+#define WAL_MAGIC 0x4C415753u              // "SWAL"
+#define WAL_VERSION 1
+
+enum WalOp : uint8_t {
+    WAL_REGISTER = 1,
+    WAL_DEREGISTER = 2,    // Also ends all of the user's PDU sessions
+    WAL_PDU_SESSION = 3,
+};
+
+// Start of every log file
+struct WalHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint64_t base_lsn;     // The first record is base_lsn + 1
+};
+static_assert(sizeof(WalHeader) == 16, "WAL header must be 16 bytes");
+
+// One state change as stored on disk (host byte order)
+struct WalRecord {
+    uint32_t checksum;     // crc32() of the bytes after this field
+    int32_t id;
+    uint8_t op;            // WalOp
+    uint8_t pdu_id;        // WAL_PDU_SESSION: the PDU ID (1-15) assigned
+    uint8_t sst;
+    uint8_t reserved;
+    uint16_t sd;
+    uint16_t reserved2;
+};
+static_assert(sizeof(WalRecord) == 16, "WAL records must be 16 bytes");
+
+inline uint32_t wal_checksum(const WalRecord& record) {
+    return crc32(reinterpret_cast<const char*>(&record) + sizeof(record.checksum),
+                 sizeof(record) - sizeof(record.checksum));
+}
+
+// Function to fsync the directory holding 'path', making renames durable
+inline bool sync_parent_directory(const std::string& path) {
+    size_t slash = path.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    close(fd);
+    return ok;
+}
+
+// Wakes one event loop after a commit. The loop polls 'fd' (an eventfd) and
+// sets 'armed' while it holds replies; the flusher signals armed wakers only.
+struct WalWaker {
+    int fd = -1;
+    std::atomic<bool> armed{false};
+};
+
+class WriteAheadLog {
+public:
+    WriteAheadLog() = default;
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    ~WriteAheadLog() {
+        if (flusher_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            wake_flusher_.notify_one();
+            flusher_.join();
+        }
+        if (fd_ >= 0) close(fd_);
+    }
+
+    // Opens (or creates) the log, passes every valid record after LSN
+    // 'skip_through' (that of the snapshot loaded, else 0) to apply(record) in
+    // order, then starts the flusher. Returns false if the files cannot be used.
+    bool open(const std::string& path, int commit_us, uint64_t skip_through,
+              const std::function<void(const WalRecord&)>& apply) {
+        path_ = path;
+        commit_budget_ = std::chrono::microseconds(std::max(0, commit_us));
+
+        // A crash during roll() can leave the new file only as PATH.next
+        if (access(path.c_str(), F_OK) != 0 && access(next_path().c_str(), F_OK) == 0) {
+            if (rename(next_path().c_str(), path.c_str()) != 0) return fail("Cannot rename", next_path());
+        }
+        unlink(next_path().c_str());
+
+        uint64_t previous_base = 0, previous_last = 0;
+        int prev = ::open(previous_path().c_str(), O_RDWR | O_CLOEXEC);
+        if (prev >= 0) {
+            has_previous_ = true;
+            bool ok = replay_segment(prev, previous_path(), skip_through, skip_through, apply,
+                                     previous_base, previous_last);
+            close(prev);
+            if (!ok) return false;
+        }
+
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) return fail("Cannot open", path);
+        uint64_t base = 0, last = 0;
+        if (!replay_segment(fd_, path, skip_through, has_previous_ ? previous_last : skip_through, apply, base, last)) {
+            return false;
+        }
+        if (has_previous_ && base != previous_last) {
+            std::cerr << "WAL " << path << " starts after LSN " << base << " but " << previous_path()
+                      << " ends at LSN " << previous_last << "\n";
+            return false;
+        }
+        uint64_t first = has_previous_ ? previous_base : base;
+        if (first > skip_through) {
+            std::cerr << "WAL " << path << " starts after LSN " << first << "; it needs the snapshot"
+                      << " it was truncated for (--snapshot)\n";
+            return false;
+        }
+        if (last < skip_through) {
+            std::cerr << "WAL " << path << " ends at LSN " << last << ", before the snapshot's LSN "
+                      << skip_through << "; move it away to start a new log\n";
+            return false;
+        }
+
+        appended_.store(last);
+        durable_.store(last);
+        LOG_INFO("WAL: replayed {} records after LSN {}, log ends at LSN {}", replayed_, skip_through, last);
+        flusher_ = std::thread(&WriteAheadLog::flush_loop, this);
+        return true;
+    }
+
+    // Adds a record to the current group. Returns its LSN.
+    uint64_t append(WalRecord record) {
+        record.checksum = wal_checksum(record);
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool first = pending_.empty();
+        if (first) group_started_ = std::chrono::steady_clock::now();
+        pending_.append(reinterpret_cast<const char*>(&record), sizeof(record));
+        uint64_t lsn = appended_.load(std::memory_order_relaxed) + 1;
+        appended_.store(lsn, std::memory_order_release);
+        if (first || pending_.size() >= WAL_MAX_GROUP_BYTES) wake_flusher_.notify_one();
+        return lsn;
+    }
+
+    // LSN of the last appended record; every change made so far is covered by it
+    uint64_t appended() const { return appended_.load(std::memory_order_acquire); }
+
+    // LSN of the last record synced to disk
+    uint64_t durable() const { return durable_.load(); }
+
+    // Registers an event loop's waker; it must outlive the log
+    void add_waker(WalWaker* waker) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wakers_.push_back(waker);
+    }
+
+    // Runs fn() once record 'lsn' is durable: now, or on the flusher thread
+    void defer(uint64_t lsn, std::function<void()> fn) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (durable_.load() < lsn) {
+                deferred_.emplace_back(lsn, std::move(fn));
+                return;
+            }
+        }
+        fn();
+    }
+
+    // Blocks until record 'lsn' is durable
+    void wait_durable(uint64_t lsn) {
+        std::mutex done_mutex;
+        std::condition_variable done_signal;
+        bool done = false;
+        defer(lsn, [&] {
+            std::lock_guard<std::mutex> lock(done_mutex);
+            done = true;
+            done_signal.notify_one();
+        });
+        std::unique_lock<std::mutex> lock(done_mutex);
+        done_signal.wait(lock, [&] { return done; });
+    }
+
+    // Moves the records written so far to PATH.prev and continues in a new
+    // PATH, between two groups. Does nothing while an older PATH.prev is still
+    // needed (a snapshot failed since the last roll). Returns when done.
+    void roll() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (has_previous_) return;
+        roll_requested_ = true;
+        wake_flusher_.notify_one();
+        rolled_.wait(lock, [&] { return !roll_requested_; });
+    }
+
+    // Deletes PATH.prev; only once a durable snapshot covers every record in it
+    void drop_previous() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!has_previous_) return;
+        if (unlink(previous_path().c_str()) != 0 && errno != ENOENT) {
+            LOG_WARN("WAL: cannot delete {}", previous_path());
+            return;
+        }
+        has_previous_ = false;
+    }
+
+private:
+    std::string previous_path() const { return path_ + ".prev"; }
+    std::string next_path() const { return path_ + ".next"; }
+
+    bool fail(const char* what, const std::string& path) {
+        std::cerr << what << " WAL " << path << ": " << strerror(errno) << "\n";
+        return false;
+    }
+
+    // Function to read one file: its header (written now, with 'new_base',
+    // if the file is empty), then every whole record with a valid checksum,
+    // stopping at the first invalid one, where the file is cut. Returns the
+    // LSN before the file's first record in 'base' and its last in 'last'.
+    bool replay_segment(int fd, const std::string& path, uint64_t skip_through, uint64_t new_base,
+                        const std::function<void(const WalRecord&)>& apply, uint64_t& base, uint64_t& last) {
+        WalHeader header{};
+        ssize_t n = pread(fd, &header, sizeof(header), 0);
+        if (n < 0) return fail("Cannot read", path);
+        uint64_t offset = sizeof(header);
+        if (n < static_cast<ssize_t>(sizeof(header))) {
+            // New file, or torn while its header was written: no records yet
+            header = WalHeader{WAL_MAGIC, WAL_VERSION, 0, new_base};
+            if (ftruncate(fd, 0) != 0 || pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+                fdatasync(fd) != 0) {
+                return fail("Cannot initialize", path);
+            }
+        } else if (header.magic != WAL_MAGIC) {
+            std::cerr << "WAL " << path << " is not a write-ahead log\n";
+            return false;
+        } else if (header.version != WAL_VERSION) {
+            std::cerr << "WAL " << path << " has unsupported version " << header.version << "\n";
+            return false;
+        }
+        base = header.base_lsn;
+        last = base;
+
+        std::vector<char> buffer(WAL_READ_CHUNK);
+        size_t filled = 0;
+        uint64_t valid_end = offset;
+        bool corrupt = false;
+        while (!corrupt) {
+            n = pread(fd, buffer.data() + filled, buffer.size() - filled, static_cast<off_t>(offset));
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return fail("Cannot read", path);
+            }
+            offset += static_cast<uint64_t>(n);
+            filled += static_cast<size_t>(n);
+            size_t used = 0;
+            for (; used + sizeof(WalRecord) <= filled; used += sizeof(WalRecord)) {
+                WalRecord record;
+                std::memcpy(&record, buffer.data() + used, sizeof(record));
+                if (record.checksum != wal_checksum(record)) {
+                    corrupt = true;
+                    break;
+                }
+                if (++last > skip_through) {
+                    apply(record);
+                    ++replayed_;
+                }
+                valid_end += sizeof(WalRecord);
+            }
+            if (n == 0) break;  // A partial record at the end is torn
+            std::memmove(buffer.data(), buffer.data() + used, filled - used);
+            filled -= used;
+        }
+
+        off_t size = lseek(fd, 0, SEEK_END);
+        if (size < 0) return fail("Cannot read", path);
+        if (static_cast<uint64_t>(size) != valid_end) {
+            LOG_WARN("WAL: dropped {} bytes of torn or corrupt records from {}",
+                     static_cast<uint64_t>(size) - valid_end, path);
+            if (ftruncate(fd, static_cast<off_t>(valid_end)) != 0) return fail("Cannot truncate", path);
+        }
+        if (lseek(fd, static_cast<off_t>(valid_end), SEEK_SET) < 0) return fail("Cannot seek", path);
+        return true;
+    }
+
+    // Writes and syncs one group. A failed write or sync leaves the log in
+    // an unknown state and acks already promised, so the process stops.
+    void commit(int fd, const char* data, size_t len) {
+        size_t written = 0;
+        while (written < len) {
+            ssize_t n = write(fd, data + written, len - written);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                std::cerr << "WAL write failed: " << strerror(errno) << "\n";
+                std::abort();
+            }
+            written += static_cast<size_t>(n);
+        }
+        if (fdatasync(fd) != 0) {
+            std::cerr << "WAL fdatasync failed: " << strerror(errno) << "\n";
+            std::abort();
+        }
+    }
+
+    // Function to start a new file after LSN 'lsn', everything up to which is
+    // already in the current one. Runs on the flusher between groups.
+    void switch_files(uint64_t lsn) {
+        int fd = ::open(next_path().c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            LOG_ERROR("WAL: cannot create {}, not rolling", next_path());
+            return;
+        }
+        WalHeader header{WAL_MAGIC, WAL_VERSION, 0, lsn};
+        commit(fd, reinterpret_cast<const char*>(&header), sizeof(header));
+        // Once PATH is renamed away, PATH.next is the log (see open())
+        if (rename(path_.c_str(), previous_path().c_str()) != 0 ||
+            rename(next_path().c_str(), path_.c_str()) != 0 || !sync_parent_directory(path_)) {
+            std::cerr << "WAL rename failed: " << strerror(errno) << "\n";
+            std::abort();
+        }
+        close(fd_);
+        fd_ = fd;
+        std::lock_guard<std::mutex> lock(mutex_);
+        has_previous_ = true;
+    }
+
+    void flush_loop() {
+        std::string group;
+        std::vector<std::pair<uint64_t, std::function<void()>>> ready;
+        std::vector<WalWaker*> wakers;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_flusher_.wait(lock, [&] { return !pending_.empty() || roll_requested_ || stopping_; });
+            if (pending_.empty() && !roll_requested_) break;
+            if (!pending_.empty() && !roll_requested_) {
+                // Let the group fill for up to the commit budget after its first record
+                wake_flusher_.wait_until(lock, group_started_ + commit_budget_, [&] {
+                    return pending_.size() >= WAL_MAX_GROUP_BYTES || roll_requested_ || stopping_;
+                });
+            }
+            group.swap(pending_);
+            uint64_t lsn = appended_.load(std::memory_order_relaxed);
+            bool roll = roll_requested_;
+            lock.unlock();
+
+            if (!group.empty()) commit(fd_, group.data(), group.size());
+            group.clear();
+            durable_.store(lsn);
+            if (roll) switch_files(lsn);
+
+            lock.lock();
+            if (roll) {
+                roll_requested_ = false;
+                rolled_.notify_all();
+            }
+            // defer() checks durable_ under the lock, so no callback is missed
+            for (size_t i = 0; i < deferred_.size();) {
+                if (deferred_[i].first <= lsn) {
+                    ready.push_back(std::move(deferred_[i]));
+                    deferred_[i] = std::move(deferred_.back());
+                    deferred_.pop_back();
+                } else {
+                    ++i;
+                }
+            }
+            wakers.assign(wakers_.begin(), wakers_.end());
+            lock.unlock();
+
+            for (auto& entry : ready) entry.second();
+            ready.clear();
+            // Loops arm before re-checking durable(), so an unarmed loop has seen this commit
+            for (WalWaker* waker : wakers) {
+                if (waker->armed.exchange(false)) {
+                    uint64_t one = 1;
+                    (void)!write(waker->fd, &one, sizeof(one));
+                }
+            }
+            lock.lock();
+        }
+    }
+
+    std::string path_;
+    int fd_ = -1;                       // Only the flusher writes after open()
+    std::chrono::microseconds commit_budget_{WAL_DEFAULT_COMMIT_US};
+    std::atomic<uint64_t> appended_{0};
+    std::atomic<uint64_t> durable_{0};
+    uint64_t replayed_ = 0;             // Records applied by open()
+
+    std::mutex mutex_;                  // Guards everything below
+    std::condition_variable wake_flusher_;
+    std::condition_variable rolled_;
+    std::string pending_;               // Records of the open group
+    std::chrono::steady_clock::time_point group_started_;
+    std::vector<std::pair<uint64_t, std::function<void()>>> deferred_;
+    std::vector<WalWaker*> wakers_;
+    bool roll_requested_ = false;
+    bool has_previous_ = false;         // PATH.prev exists
+    bool stopping_ = false;
+    std::thread flusher_;
+};
+
+#endif // WAL_H